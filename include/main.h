@@ -7,6 +7,8 @@
 
 #include "api.h"
 #include "lemlib/api.hpp"
+#include "robot/chassis.hpp"
+#include "robot/odom.hpp"
 #include "liblvgl/lvgl.h"
 
 #ifdef __cplusplus
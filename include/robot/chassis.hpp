@@ -0,0 +1,575 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "robot/feedforward.hpp"
+#include "robot/motionProfile.hpp"
+#include "robot/path.hpp"
+#include "robot/traction.hpp"
+
+namespace robot {
+/**
+ * @brief Progress of a chassis calibration
+ */
+struct CalibrationStatus {
+        /** estimated fraction of the current IMU calibration attempt that is done, from 0 to 1 */
+        float progress = 0;
+        /** whether the calibration finished and odometry is running */
+        bool done = false;
+        /** number of times the IMU has been calibrated so far */
+        int imuAttempts = 0;
+        /** whether the IMU failed to calibrate, so odometry runs without it */
+        bool imuFailed = false;
+};
+
+/**
+ * @brief Handle to a calibration running in the background
+ *
+ * Copies of the handle refer to the same calibration, and the handle can be dropped without stopping it.
+ */
+class CalibrationHandle {
+    public:
+        /**
+         * @brief Get the progress of the calibration
+         *
+         * @return CalibrationStatus
+         */
+        CalibrationStatus getStatus() const;
+        /**
+         * @return whether the calibration finished
+         */
+        bool isDone() const;
+        /**
+         * @brief Wait for the calibration to finish
+         *
+         * @param timeout longest time to wait, in milliseconds. Waits forever by default
+         * @return whether the calibration finished
+         */
+        bool wait(std::uint32_t timeout = TIMEOUT_MAX) const;
+    private:
+        friend class Chassis;
+
+        struct State {
+                pros::Mutex mutex;
+                CalibrationStatus status;
+        };
+
+        CalibrationHandle();
+        void update(const CalibrationStatus& status) const;
+
+        std::shared_ptr<State> state;
+};
+
+/**
+ * @brief LemLib controller settings with feedforward gains
+ *
+ * The feedforward drives the profiled motions, and the PID only corrects what the feedforward doesn't predict. Fit
+ * the gains with Chassis::characterize and the characterize tool in sim/tools. Lateral gains are per inch per
+ * second, angular gains per degree per second.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::ControllerSettings lateralController(4, // kP
+ *                                             0, // kI
+ *                                             3, // kD
+ *                                             3, // anti windup
+ *                                             1, 100, // small error range, timeout
+ *                                             3, 500, // large error range, timeout
+ *                                             20, // max acceleration
+ *                                             6.5, 1.62, 0.21 // kS, kV, kA
+ * );
+ * @endcode
+ */
+class ControllerSettings : public lemlib::ControllerSettings {
+    public:
+        ControllerSettings(float kP, float kI, float kD, float windupRange, float smallError, float smallErrorTimeout,
+                           float largeError, float largeErrorTimeout, float slew, float kS = 0, float kV = 0,
+                           float kA = 0)
+            : lemlib::ControllerSettings(kP, kI, kD, windupRange, smallError, smallErrorTimeout, largeError,
+                                         largeErrorTimeout, slew),
+              feedforward {kS, kV, kA} {}
+
+        Feedforward feedforward;
+};
+
+/**
+ * @brief Parameters for Chassis::moveToPointProfiled
+ */
+struct ProfiledMoveParams {
+        /** whether the robot should move forwards or backwards. true by default */
+        bool forwards = true;
+        /** limits of the motion profile */
+        ProfileConstraints constraints = {};
+        /** velocity to pass the target at instead of stopping, in inches per second. 0 by default */
+        float exitVelocity = 0;
+        /** distance from the target to hand off to the next motion at, in inches. 0 by default */
+        float earlyExitRange = 0;
+};
+
+/**
+ * @brief Parameters for Chassis::turnToHeadingProfiled
+ */
+struct ProfiledTurnParams {
+        /** the direction the robot should turn in. AUTO by default */
+        lemlib::AngularDirection direction = lemlib::AngularDirection::AUTO;
+        /** limits of the motion profile, in degrees instead of inches */
+        ProfileConstraints constraints = {0, 720, 7200};
+};
+
+/**
+ * @brief Parameters for Chassis::followProfiled
+ */
+struct ProfiledFollowParams {
+        /** whether the robot should move forwards or backwards. true by default */
+        bool forwards = true;
+        /** fastest the robot may move, in inches per second. 0 for the drivetrain's top speed */
+        float maxVelocity = 0;
+        /** fastest the robot may speed up or slow down, in inches per second squared. 120 by default */
+        float maxAcceleration = 120;
+        /** fastest the robot may accelerate sideways in turns, in inches per second squared. 80 by default */
+        float maxLateralAcceleration = 80;
+        /** RAMSETE correction gain, in rad^2/m^2. 2 by default */
+        float b = 2;
+        /** RAMSETE damping, from 0 to 1. 0.7 by default */
+        float zeta = 0.7;
+        /** velocity to pass the end of the path at instead of stopping, in inches per second. 0 by default */
+        float exitVelocity = 0;
+        /** distance from the end of the path to hand off to the next motion at, in inches. 0 by default */
+        float earlyExitRange = 0;
+};
+
+/**
+ * @brief Parameters for Chassis::characterize
+ */
+struct CharacterizationParams {
+        /** whether to turn in place instead of driving straight. false by default */
+        bool angular = false;
+        /** how fast the power ramps up, in power per second. 8 by default */
+        float rampRate = 8;
+        /** length of the ramp, in milliseconds. 5000 by default */
+        int rampTime = 5000;
+        /** power of the step. 70 by default */
+        float stepPower = 70;
+        /** length of the step, in milliseconds. 1500 by default */
+        int stepTime = 1500;
+        /** whether to move backwards. false by default */
+        bool reversed = false;
+};
+
+/**
+ * @brief Settings of Chassis::setVelocityDrive
+ */
+struct VelocityDriveSettings {
+        /** proportional gain of the wheel velocity PID, in power per inch per second. 2 by default */
+        float kP = 2;
+        /** integral gain of the wheel velocity PID. 0 by default */
+        float kI = 0;
+        /** derivative gain of the wheel velocity PID. 0 by default */
+        float kD = 0;
+        /** fastest the wheel velocity targets may change, in inches per second squared. 0 for no limit */
+        float maxAcceleration = 0;
+};
+
+/**
+ * @brief LemLib chassis with the team's extensions
+ *
+ * Drop-in replacement for lemlib::Chassis. Everything LemLib provides works the same way, the extensions are built
+ * on the protected members LemLib exposes for subclasses.
+ */
+class Chassis : public lemlib::Chassis {
+    public:
+        using lemlib::Chassis::Chassis;
+
+        /**
+         * @brief Create a new Chassis with feedforward gains
+         *
+         * @param drivetrain drivetrain to be used for the chassis
+         * @param lateralSettings settings for the lateral controller
+         * @param angularSettings settings for the angular controller
+         * @param sensors sensors to be used for odometry
+         * @param throttleCurve curve applied to throttle input during driver control
+         * @param steerCurve curve applied to steer input during driver control
+         */
+        Chassis(lemlib::Drivetrain drivetrain, ControllerSettings lateralSettings, ControllerSettings angularSettings,
+                lemlib::OdomSensors sensors, lemlib::DriveCurve* throttleCurve = &lemlib::defaultDriveCurve,
+                lemlib::DriveCurve* steerCurve = &lemlib::defaultDriveCurve);
+
+        /**
+         * @brief Calibrate the chassis sensors and start odometry. This should be called in the initialize function
+         *
+         * Works like lemlib::Chassis::calibrate, except odometry runs on robot::initOdom's fixed-rate task instead
+         * of LemLib's own task.
+         *
+         * @param calibrateIMU whether the IMU should be calibrated. true by default
+         * @param odomPeriod time between odometry updates, in milliseconds. 10 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * void initialize() {
+         *     // update odometry every 5ms
+         *     chassis.calibrate(true, 5);
+         * }
+         * @endcode
+         */
+        void calibrate(bool calibrateIMU = true, std::uint32_t odomPeriod = 10);
+        /**
+         * @brief Calibrate the chassis sensors and start odometry in the background
+         *
+         * Same as calibrate, but returns immediately so the screen and auton selector can be set up while the IMU
+         * calibrates. The tracking wheels are reset while the IMU calibrates instead of after. Don't move the robot
+         * or start motions until the calibration is done.
+         *
+         * @param calibrateIMU whether the IMU should be calibrated. true by default
+         * @param odomPeriod time between odometry updates, in milliseconds. 10 by default
+         * @return CalibrationHandle to follow the progress of the calibration
+         *
+         * @b Example
+         * @code {.cpp}
+         * robot::CalibrationHandle calibration = chassis.calibrateAsync();
+         * setupScreen();
+         * while (!calibration.isDone()) {
+         *     pros::lcd::print(0, "calibrating: %.0f%%", calibration.getStatus().progress * 100);
+         *     pros::delay(50);
+         * }
+         * @endcode
+         */
+        CalibrationHandle calibrateAsync(bool calibrateIMU = true, std::uint32_t odomPeriod = 10);
+        /**
+         * @brief Keep the drivetrain's output the same as the battery drains
+         *
+         * move() asks the motors for a fraction of the battery's voltage, so the same power drives slower as the
+         * battery sags over a match. With compensation on, the chassis reads the battery voltage every time it drives
+         * the motors and sends them move_voltage() commands that deliver the power's share of the nominal voltage
+         * instead. Driving and the robot:: motions feel the same on a full battery and at the end of a match, and
+         * feedforward gains characterized with compensation on hold at any charge.
+         *
+         * The nominal voltage is what full power delivers. Powers that would need more than the battery has are
+         * capped at full voltage, so a nominal voltage below a full battery's keeps headroom on a sagging battery.
+         * LemLib's own motions aren't affected, since they drive the motors from inside LemLib.
+         *
+         * @param enabled whether to compensate. Off until this is called
+         * @param nominalVoltage voltage full power delivers, in millivolts. 12000 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * void initialize() {
+         *     chassis.calibrate();
+         *     // full power delivers 11.5V, whatever the battery is at
+         *     chassis.setVoltageCompensation(true, 11500);
+         * }
+         * @endcode
+         */
+        void setVoltageCompensation(bool enabled, std::int32_t nominalVoltage = 12000);
+        /**
+         * @brief Drive wheel velocities instead of powers during driver control
+         *
+         * With velocity drive on, tank, arcade and curvature treat their curved output as a fraction of the
+         * drivetrain's top speed for each side. The lateral feedforward drives that velocity and a PID on the drive
+         * motors' measured velocity corrects the rest, so a side that's pushed or dragged gets more power until it's
+         * back at the speed the driver asked for. The robot drives straighter and accelerates the same way whatever is
+         * pushing on it. The PID runs every time tank, arcade or curvature is called, so call them every 10ms.
+         *
+         * Unlike move_velocity, nothing runs through the motors' built-in velocity controller, which is tuned
+         * conservatively and reacts slowly.
+         *
+         * @param enabled whether to drive velocities. Off until this is called
+         * @param settings gains and acceleration limit of the velocity controller
+         *
+         * @b Example
+         * @code {.cpp}
+         * void opcontrol() {
+         *     chassis.setVelocityDrive(true, {.kP = 3, .maxAcceleration = 200});
+         *     while (true) {
+         *         chassis.arcade(controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
+         *                        controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X));
+         *         pros::delay(10);
+         *     }
+         * }
+         * @endcode
+         */
+        void setVelocityDrive(bool enabled, VelocityDriveSettings settings = {});
+        /**
+         * @brief Limit the drivetrain's acceleration while its wheels slip
+         *
+         * Every time the chassis drives the motors, each side's wheel velocity from the drive motors' encoders is
+         * compared with the velocity of the ground under it from odometry. A side whose wheels turn faster or slower
+         * than the ground is slipping, and its power can only change at the slew rate until it grips again. When the
+         * wheels spin in the direction they're driven, the power also backs off towards what the ground speed takes.
+         * Covers driver control through tank, arcade and curvature and the robot:: motions, not LemLib's own motions.
+         *
+         * Needs a vertical tracking wheel, since odometry from the drive encoders can't see their own slip.
+         *
+         * @param enabled whether to control traction. Off until this is called
+         * @param settings slip threshold and slew rate
+         *
+         * @b Example
+         * @code {.cpp}
+         * void initialize() {
+         *     chassis.calibrate();
+         *     chassis.setTractionControl(true, {.threshold = 0.25});
+         * }
+         * @endcode
+         */
+        void setTractionControl(bool enabled, TractionSettings settings = {});
+        /**
+         * @return whether either side of the drivetrain is slipping. Always false with traction control off
+         */
+        bool isSlipping() const;
+        /**
+         * @brief Control the robot during the driver using tank drive
+         *
+         * Same as lemlib::Chassis::tank, with voltage compensation, velocity drive and traction control when they're
+         * on.
+         *
+         * @param left speed to move left wheels forward or backward. Takes an input from -127 to 127.
+         * @param right speed to move right wheels forward or backward. Takes an input from -127 to 127.
+         * @param disableDriveCurve whether to disable the drive curve or not. If disabled, uses a linear curve with no
+         * deadzone or minimum power
+         */
+        void tank(int left, int right, bool disableDriveCurve = false);
+        /**
+         * @brief Control the robot during the driver using arcade drive
+         *
+         * Same as lemlib::Chassis::arcade, with voltage compensation, velocity drive and traction control when they're
+         * on.
+         *
+         * @param throttle speed to move forward or backward. Takes an input from -127 to 127.
+         * @param turn speed to turn. Takes an input from -127 to 127.
+         * @param disableDriveCurve whether to disable the drive curve or not. If disabled, uses a linear curve with no
+         * deadzone or minimum power
+         * @param desaturateBias how much to favor angular motion over lateral motion or vice versa when motors are
+         * saturated. A value of 0 fully prioritizes lateral motion, a value of 1 fully prioritizes angular motion
+         */
+        void arcade(int throttle, int turn, bool disableDriveCurve = false, float desaturateBias = 0.5);
+        /**
+         * @brief Control the robot during the driver using curvature drive
+         *
+         * Same as lemlib::Chassis::curvature, with voltage compensation, velocity drive and traction control when
+         * they're on.
+         *
+         * @param throttle speed to move forward or backward. Takes an input from -127 to 127.
+         * @param turn speed to turn. Takes an input from -127 to 127.
+         * @param disableDriveCurve whether to disable the drive curve or not. If disabled, uses a linear curve with no
+         * deadzone or minimum power
+         */
+        void curvature(int throttle, int turn, bool disableDriveCurve = false);
+        /**
+         * @brief Move the chassis towards a point along a planned motion profile
+         *
+         * Works like moveToPoint, except the distance to the point is planned ahead as a jerk-limited S-curve
+         * profile instead of leaving acceleration to the PID and slew. Each step drives the profile's velocity as
+         * feedforward, and the lateral PID only corrects the difference between where the profile and the robot
+         * are. Acceleration is the same every run no matter the battery or the PID gains, so the slew doesn't need
+         * tuning. Once the profile ends, the motion exits like moveToPoint on the lateral exit conditions.
+         *
+         * Motions can be chained without stopping in between. With an exit velocity, the profile passes the target
+         * at that velocity instead of slowing to a stop, and the motion exits as soon as it gets there. With an early
+         * exit range, the motion exits that far from the target. Either way, the velocity the robot exits at is
+         * carried into the next profiled motion, which starts its profile from it instead of from rest. The motors
+         * are only left running if the next motion is already queued, so queue the chain with async motions.
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // move 48 inches forwards, speeding up and slowing down at 100in/s^2
+         * chassis.moveToPointProfiled(0, 48, 3000, {.constraints = {.maxAcceleration = 100}});
+         * // pass through (24, 72) at 40in/s and carry on to (48, 72) without stopping
+         * chassis.moveToPointProfiled(24, 72, 3000, {.exitVelocity = 40});
+         * chassis.moveToPointProfiled(48, 72, 3000);
+         * @endcode
+         */
+        void moveToPointProfiled(float x, float y, int timeout, ProfiledMoveParams params = {}, bool async = true);
+        /**
+         * @brief Turn the chassis to face a heading along a planned motion profile
+         *
+         * The turn counterpart of moveToPointProfiled: the angle to turn is planned as a jerk-limited S-curve, the
+         * angular feedforward drives it and the angular PID corrects the difference. Exits on the angular exit
+         * conditions once the profile ends. Turns in place start from rest, so velocity carried from the last motion is
+         * dropped.
+         *
+         * @param theta heading location, in degrees
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // turn to face 90 degrees clockwise
+         * chassis.turnToHeadingProfiled(90, 1000, {.direction = lemlib::AngularDirection::CW_CLOCKWISE});
+         * @endcode
+         */
+        void turnToHeadingProfiled(float theta, int timeout, ProfiledTurnParams params = {}, bool async = true);
+        /**
+         * @brief Follow a path along a time-optimal velocity profile
+         *
+         * Replacement for follow's pure pursuit. The whole path is planned before the robot moves: every point gets
+         * the fastest velocity the path's speeds, the drivetrain's top speed, the sideways acceleration limit in
+         * turns and the acceleration limit allow. A RAMSETE controller then tracks where the robot should be at each
+         * moment, with the lateral feedforward driving each wheel. There is no lookahead, so the robot neither cuts
+         * corners nor has to slow down to stop cutting them. Exits on the lateral exit conditions once the profile
+         * ends, or at the timeout. Chains with other profiled motions through exitVelocity and earlyExitRange like
+         * moveToPointProfiled.
+         *
+         * @param path the path to follow, declared with PATH_ASSET
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * PATH_ASSET(example);
+         *
+         * void autonomous() {
+         *     chassis.setPose(0, 0, 0);
+         *     chassis.followProfiled(example_path, 4000, {.maxAcceleration = 100});
+         * }
+         * @endcode
+         */
+        void followProfiled(PathView path, int timeout, ProfiledFollowParams params = {}, bool async = true);
+        using lemlib::Chassis::follow;
+        /**
+         * @brief Follow a binary path with pure pursuit
+         *
+         * Works like LemLib's follow, but reads a path declared with PATH_ASSET and searches it with a PathIndex:
+         * the closest point and the lookahead point cost the same on every loop no matter how long the path is,
+         * where LemLib's follow scans the whole path twice per loop.
+         *
+         * @param path the path to follow, declared with PATH_ASSET
+         * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move faster but
+         * will follow the path less accurately
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards. true by default
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * PATH_ASSET(skills);
+         *
+         * void autonomous() {
+         *     chassis.setPose(0, 0, 0);
+         *     chassis.follow(skills_path, 15, 20000);
+         * }
+         * @endcode
+         */
+        void follow(PathView path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        /**
+         * @brief Follow a path in the text format along a time-optimal velocity profile
+         *
+         * Same as the PathView overload, but parses the path first, which takes time and memory at the start of the
+         * motion. Prefer PATH_ASSET, which gets the build to do the parsing.
+         *
+         * @param path the path asset to follow, in the same format as follow
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void followProfiled(const asset& path, int timeout, ProfiledFollowParams params = {}, bool async = true);
+        /**
+         * @brief Log a characterization run to the terminal, to fit the feedforward gains with
+         *
+         * Ramps the motor power up slowly, stops, then applies a sudden step of power, printing
+         * "time,power,velocity" lines while the robot moves. Velocity comes from odometry, in inches per second or
+         * degrees per second when turning. Save the terminal output, then fit the gains on a computer with
+         * sim/bin/characterize, built by make -C sim tools. Run it a few times in both directions for the best fit.
+         * Needs a few feet of clear field in front of the robot, and blocks until done.
+         *
+         * @param params struct to simulate named parameters
+         *
+         * @b Example
+         * @code {.cpp}
+         * void autonomous() {
+         *     chassis.characterize();
+         *     chassis.characterize({.reversed = true});
+         * }
+         * @endcode
+         */
+        void characterize(CharacterizationParams params = {});
+    private:
+        /**
+         * @return the lateral feedforward, or the drivetrain's ideal one if it wasn't characterized
+         */
+        Feedforward getLateralFeedforward() const;
+        /**
+         * @return the angular feedforward, or the drivetrain's ideal one if it wasn't characterized
+         */
+        Feedforward getAngularFeedforward() const;
+        /**
+         * @brief Drive both sides of the drivetrain, through traction control and voltage compensation if enabled
+         *
+         * @param left power of the left side, from -127 to 127
+         * @param right power of the right side, from -127 to 127
+         */
+        void drive(float left, float right);
+        /**
+         * @brief Drive both sides with driver control powers, through the velocity controller if it's on
+         *
+         * @param left power of the left side, from -127 to 127
+         * @param right power of the right side, from -127 to 127
+         */
+        void driverOutput(float left, float right);
+        /**
+         * @brief Get the velocity of a side of the drivetrain from its motors' encoders
+         *
+         * @param motors the motors of the side
+         * @return the velocity of the wheels, in inches per second
+         */
+        float wheelVelocity(pros::MotorGroup* motors) const;
+        /**
+         * @brief Hand the velocity the robot exits a motion at to the next motion
+         *
+         * Leaves the drivetrain running if there is velocity to hand off and the next motion is already queued, and
+         * stops it otherwise. If the queued motion is cancelled before it starts, it stops the drivetrain with
+         * dropHandOff.
+         *
+         * @param velocityX x velocity the motion exits at, in inches per second
+         * @param velocityY y velocity the motion exits at, in inches per second
+         */
+        void handOff(float velocityX, float velocityY);
+        /**
+         * @brief Stop the drivetrain the last motion left running for this one, for when this motion was cancelled
+         */
+        void dropHandOff();
+        /**
+         * @brief Take the velocity the last motion handed off, if it ended just now
+         *
+         * @param directionX x component of the direction the next motion starts in, a unit vector
+         * @param directionY y component of the direction the next motion starts in
+         * @return the velocity to start the next motion at, along the direction, in inches per second
+         */
+        float takeEntryVelocity(float directionX, float directionY);
+
+        Feedforward lateralFeedforward;
+        Feedforward angularFeedforward;
+        bool voltageCompensation = false;
+        /** voltage full power delivers with compensation on, in millivolts */
+        std::int32_t nominalVoltage = 12000;
+        bool velocityDrive = false;
+        VelocityDriveSettings velocitySettings;
+        /** PIDs of the velocity controller, rebuilt when the gains change since LemLib's PID can't be reassigned */
+        std::optional<lemlib::PID> leftVelocityPID;
+        std::optional<lemlib::PID> rightVelocityPID;
+        /** wheel velocity targets of the velocity controller, in inches per second */
+        float leftTarget = 0;
+        float rightTarget = 0;
+        /** when the velocity controller last ran, in milliseconds */
+        std::uint32_t lastDriverOutput = 0;
+        bool tractionControl = false;
+        TractionControl leftTraction;
+        TractionControl rightTraction;
+        /** when traction control last ran, in milliseconds */
+        std::uint32_t lastTraction = 0;
+        /** velocity the last motion handed off, in inches per second */
+        float carriedX = 0;
+        float carriedY = 0;
+        /** when the last motion handed off its velocity, in milliseconds */
+        std::uint32_t carriedTime = 0;
+};
+} // namespace robot
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace robot {
+/**
+ * @brief Feedforward gains of a drivetrain motion
+ *
+ * Predicts the motor power a velocity and acceleration take: kS * sign(velocity) + kV * velocity + kA * acceleration.
+ * Power is LemLib's motor power from -127 to 127. Velocities are in inches per second for lateral motions and
+ * degrees per second for turns.
+ */
+struct Feedforward {
+        /** power to overcome friction */
+        float kS = 0;
+        /** power per unit of velocity */
+        float kV = 0;
+        /** power per unit of acceleration */
+        float kA = 0;
+
+        /**
+         * @brief Get the power a velocity and acceleration take
+         *
+         * @param velocity the velocity
+         * @param acceleration the acceleration. 0 by default
+         * @return the motor power
+         */
+        float calculate(float velocity, float acceleration = 0) const;
+};
+
+/**
+ * @brief A logged motor power and the velocity it produced
+ */
+struct FeedforwardSample {
+        /** motor power, from -127 to 127 */
+        float power;
+        float velocity;
+        float acceleration;
+};
+
+/**
+ * @brief Result of fitting feedforward gains
+ */
+struct FeedforwardFit {
+        Feedforward feedforward;
+        /** fraction of the variance in power the fit explains, from 0 to 1 */
+        float rSquared;
+        /** number of samples the fit used */
+        std::size_t samples;
+};
+
+/**
+ * @brief Fit feedforward gains to logged samples with least squares
+ *
+ * Samples slower than minVelocity are left out, since static friction holds the robot still over a range of powers
+ * that the model can't describe. Works best with a slow power ramp, which pins down kS and kV, combined with a few
+ * sudden power steps, which pin down kA.
+ *
+ * @param samples the samples
+ * @param minVelocity slowest velocity a sample may have to be used. 1 by default
+ * @return FeedforwardFit. All gains are 0 if the samples don't determine them
+ */
+FeedforwardFit fitFeedforward(const std::vector<FeedforwardSample>& samples, float minVelocity = 1);
+} // namespace robot
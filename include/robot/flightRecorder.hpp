@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/baseSink.hpp"
+#include "robot/ringBuffer.hpp"
+#include "robot/telemetry.hpp"
+
+namespace robot {
+/**
+ * @brief Settings of a flight recorder
+ */
+struct FlightRecorderSettings {
+        /** start of the file names on the SD card. "flight" by default, for /usd/flight0000.bin and so on */
+        std::string name = "flight";
+        /** size a file grows to before the recording moves on to the next one, in bytes. 4 MiB by default */
+        std::uint32_t fileSize = 4 << 20;
+        /** most files kept on the SD card. Starting a new file removes the oldest one past this. 16 by default */
+        std::uint32_t maxFiles = 16;
+        /** number of bytes of frames that can wait for the SD card. 32768 by default */
+        std::size_t capacity = 32768;
+};
+
+/**
+ * @brief Sink that records logged messages and telemetry samples to the SD card
+ *
+ * The terminal usually isn't attached at competition, so this keeps everything on the SD card for after the match.
+ * Files hold the same frames as TelemetryStream: a schema, the samples of every channel, and every message logged to
+ * this sink as a text frame. sim/tools/decodeTelemetry turns them into CSV.
+ *
+ * Recording a sample or logging a message encodes it and copies it into a RingBuffer without waiting, so the SD card
+ * never holds up a control loop. A writer task moves frames from the ring into a second buffer, and writes the
+ * second buffer to the file in whole 4 KiB blocks while the ring keeps filling. When a file reaches its size the
+ * recording continues in a new file, which starts with the schema and a key frame so it can be decoded on its own.
+ * Samples still waiting in the ring as differences from the previous file are dropped, and counted in the footer.
+ *
+ * Every frame has a CRC and every block is flushed to the card as soon as it is full. A block that is still filling
+ * is written padded with zeros every 250 ms, and written again over the same place when it fills, so a recording cut
+ * off by a brownout or a program crash loses at most the last 250 ms. Closing a file writes a footer with the number
+ * of samples and dropped frames, so a file without a footer was cut off.
+ *
+ * @b Example
+ * @code {.cpp}
+ * auto recorder = std::make_shared<robot::FlightRecorder>(
+ *     std::vector<robot::TelemetryChannel> {{"x"}, {"y"}, {"theta", robot::TelemetryType::SCALED, 1000}});
+ * recorder->start();
+ * lemlib::BaseSink logger({lemlib::infoSink(), recorder});
+ * logger.warn("auton started");
+ * // every 10ms, from one task
+ * recorder->record({pose.x, pose.y, pose.theta});
+ * // in disabled
+ * recorder->stop();
+ * @endcode
+ */
+class FlightRecorder : public lemlib::BaseSink {
+    public:
+        /**
+         * @brief Construct a new Flight Recorder
+         *
+         * @param channels the channels of the samples, at most TELEMETRY_MAX_CHANNELS
+         * @param settings settings of the recorder
+         */
+        FlightRecorder(std::vector<TelemetryChannel> channels, FlightRecorderSettings settings = {});
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+        /**
+         * @brief Start recording to a new file
+         *
+         * @return whether an SD card is installed. Without one nothing is recorded
+         */
+        bool start();
+        /**
+         * @brief Write everything recorded so far and a footer, and close the file. Waits for the writer task
+         */
+        void stop();
+        /**
+         * @brief Record a sample of every channel, stamped with the current time. Never blocks
+         *
+         * Only call this from one task, since every sample depends on the one before it.
+         *
+         * @param values the value of every channel, in order. Missing values are recorded as 0
+         */
+        void record(std::initializer_list<float> values);
+        /**
+         * @return whether the recorder is recording
+         */
+        bool isRecording() const;
+        /**
+         * @return the number of frames dropped because the SD card fell too far behind
+         */
+        std::uint32_t getDropped() const;
+    private:
+        /**
+         * @brief Copy a logged message into the ring buffer
+         */
+        void sendMessage(const lemlib::Message& message) override;
+        /**
+         * @brief Copy a frame into the ring buffer
+         */
+        void push(const std::uint8_t* frame, std::size_t size);
+
+        /**
+         * @brief Body of the writer task
+         */
+        void writeLoop();
+        /**
+         * @brief Move the waiting frames into blocks
+         */
+        void drain();
+        /**
+         * @brief Add bytes to the block, writing it when it is full
+         */
+        void append(const std::uint8_t* data, std::size_t size);
+        /**
+         * @brief Write the block to the file, and start a new one
+         */
+        void writeBlock();
+        /**
+         * @brief Write the block to the file before it is full, to keep filling it and write it again later
+         */
+        void flushBlock();
+        /**
+         * @brief Write the block padded with zeros and flush it to the card
+         *
+         * @return whether it was written. If not the file is closed
+         */
+        bool putBlock();
+        /**
+         * @brief Open the next file and start it with the schema
+         *
+         * @return whether the file could be opened
+         */
+        bool openNext();
+        /**
+         * @brief Write the footer and the rest of the block, and close the file
+         */
+        void close();
+        /**
+         * @brief Get the path of a file of the recording
+         */
+        std::string path(std::uint32_t index) const;
+
+        FlightRecorderSettings settings;
+        TelemetryEncoder encoder;
+        std::vector<std::uint8_t> schema;
+        /** sample being encoded, so recording doesn't allocate */
+        std::vector<std::uint8_t> frame;
+        RingBuffer ring;
+        /** block being filled by the writer task */
+        std::unique_ptr<std::uint8_t[]> block;
+        std::size_t blockUsed = 0;
+        /** bytes of the block already on the card, from flushing it before it was full */
+        std::size_t flushed = 0;
+        /** time a block was last written, in milliseconds */
+        std::uint32_t lastFlush = 0;
+        std::FILE* file = nullptr;
+        /** index of the open file, or of the next one to open */
+        std::optional<std::uint32_t> index;
+        std::uint32_t fileBytes = 0;
+        std::uint32_t fileSamples = 0;
+        std::uint32_t fileDropped = 0;
+        /** delta frames left out of the file because they came before its first key frame */
+        std::uint32_t fileSkipped = 0;
+        /** whether the file has a key frame yet */
+        bool keyWritten = false;
+        std::atomic<bool> recording = false;
+        std::atomic<bool> stopping = false;
+        /** set by the writer task when a new file starts, so the next sample is a key frame */
+        std::atomic<bool> keyNeeded = false;
+        std::optional<pros::Task> task;
+};
+} // namespace robot
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "pros/imu.hpp"
+#include "pros/rtos.hpp"
+
+namespace robot {
+/**
+ * @brief Several inertial sensors that act as one
+ *
+ * ImuGroup is a pros::Imu, so it can be passed to lemlib::OdomSensors in place of a single IMU. Rotation and heading
+ * are fused from every unit that is working:
+ *
+ * - each unit's change in rotation is compared to the median change, and units that disagree too much are ignored
+ * - the remaining changes are averaged, weighted by how noisy each unit has been
+ * - while the robot is still, each unit's drift is measured and subtracted from then on
+ * - units that disconnect, report an error or start calibrating again (after a brown-out) are dropped, and rejoin
+ *   once they are working again
+ *
+ * reset() calibrates every unit at the same time, so startup doesn't take longer with more IMUs. Functions that
+ * aren't fused, like get_pitch or get_accel, read the first unit.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::ImuGroup imus({17, 12, 3});
+ *
+ * lemlib::OdomSensors sensors(&vertical, nullptr, &horizontal, nullptr, &imus);
+ * @endcode
+ */
+class ImuGroup : public pros::Imu {
+    public:
+        /**
+         * @brief Construct a new Imu Group
+         *
+         * @param ports the ports of the inertial sensors. Must not be empty
+         */
+        ImuGroup(std::initializer_list<std::uint8_t> ports);
+        /**
+         * @brief Calibrate every unit at the same time, and reset the fused rotation and drift estimates to 0
+         *
+         * @param blocking whether to wait until every unit finished calibrating. false by default
+         * @return 1 if at least one unit started calibrating, PROS_ERR otherwise
+         */
+        std::int32_t reset(bool blocking = false) const override;
+        /**
+         * @return true while any unit that hasn't failed is calibrating
+         */
+        bool is_calibrating() const override;
+        /**
+         * @return calibrating while any unit is calibrating, ready if at least one unit works, error otherwise
+         */
+        pros::ImuStatus get_status() const override;
+        /**
+         * @return the fused rotation, in degrees. PROS_ERR_F if no unit has worked since the last reset
+         */
+        double get_rotation() const override;
+        /**
+         * @return the fused heading, from 0 to 360 degrees. PROS_ERR_F if no unit has worked since the last reset
+         */
+        double get_heading() const override;
+        /**
+         * @return the mean angular velocity of the working units
+         */
+        pros::imu_gyro_s_t get_gyro_rate() const override;
+        std::int32_t set_data_rate(std::uint32_t rate) const override;
+        std::int32_t set_rotation(const double target) const override;
+        std::int32_t set_heading(const double target) const override;
+        std::int32_t tare_rotation() const override;
+        std::int32_t tare_heading() const override;
+        /**
+         * @return the number of units currently used in the fused rotation
+         */
+        int getActiveCount() const;
+    private:
+        struct Unit {
+                pros::Imu imu;
+                /** whether the unit was working when it was last read */
+                bool active = false;
+                /** rotation read last time, in degrees */
+                double previous = 0;
+                /** drift, in degrees per millisecond */
+                double drift = 0;
+                /** variance of the unit's disagreement with the median, in degrees squared */
+                double variance = 0.0001;
+                /** change in rotation since the last update, in degrees */
+                double delta = 0;
+                /** whether delta is part of the last update */
+                bool counted = false;
+        };
+
+        /**
+         * @brief Read every unit and add the fused change in rotation
+         */
+        void update() const;
+
+        mutable std::vector<Unit> units;
+        /** scratch space for finding the median, so updates don't allocate */
+        mutable std::vector<double> sorted;
+        mutable pros::Mutex mutex;
+        mutable double rotation = 0;
+        mutable double headingOffset = 0;
+        mutable bool valid = false;
+        mutable std::uint32_t lastUpdate = 0;
+        /** how long the robot has been still, in milliseconds */
+        mutable std::uint32_t stillTime = 0;
+};
+} // namespace robot
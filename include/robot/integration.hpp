@@ -0,0 +1,46 @@
+#pragma once
+
+namespace robot {
+/**
+ * @brief How an odometry step is turned into a change in pose
+ */
+enum class Integrator {
+    /**
+     * the SE(2) exponential map: exact when the robot's velocity and angular velocity are constant during the step.
+     * This is the same motion LemLib's arc update describes, written so it stays accurate for tiny turns
+     */
+    EXPONENTIAL,
+    /**
+     * 4th order Runge-Kutta over a heading that changes at the angular velocities measured by the IMU at both ends of
+     * the step. More accurate than EXPONENTIAL when the robot speeds up or slows down its turns, so odometry can run
+     * at a lower rate for the same accuracy
+     */
+    RUNGE_KUTTA
+};
+
+/**
+ * @brief A pose, with theta in radians measured clockwise from the +y axis like LemLib
+ */
+struct IntegratorPose {
+        float x;
+        float y;
+        float theta;
+};
+
+/**
+ * @brief Move a pose by an odometry step
+ *
+ * The step is the distance the tracking center travelled along its path during the step, in the robot's frame.
+ *
+ * @param integrator how to integrate the step
+ * @param pose the pose to move
+ * @param forward distance travelled forwards, in inches
+ * @param right distance travelled to the right, in inches
+ * @param turn change in heading, in radians
+ * @param startRate angular velocity at the start of the step, in radians per second. Only used by RUNGE_KUTTA
+ * @param endRate angular velocity at the end of the step, in radians per second. Only used by RUNGE_KUTTA
+ * @param duration length of the step, in seconds. Only used by RUNGE_KUTTA
+ */
+void integrate(Integrator integrator, IntegratorPose& pose, float forward, float right, float turn,
+               float startRate = 0, float endRate = 0, float duration = 0);
+} // namespace robot
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/message.hpp"
+#include "robot/ringBuffer.hpp"
+
+#define FMT_HEADER_ONLY
+#include "fmt/core.h"
+
+#ifndef ROBOT_LOG_LEVEL
+/** lowest level of messages that are compiled in, as a lemlib::Level number. Set by LOG_LEVEL in the Makefile */
+#define ROBOT_LOG_LEVEL 0
+#endif
+
+/**
+ * @brief Log a message with robot::logger(), unless its level is below ROBOT_LOG_LEVEL
+ *
+ * Unlike calling the logger, a message below ROBOT_LOG_LEVEL compiles to nothing, not even the evaluation of its
+ * arguments.
+ *
+ * @b Example
+ * @code {.cpp}
+ * ROBOT_LOG(lemlib::Level::DEBUG, "error: {:.2f}", computeError());
+ * @endcode
+ */
+#define ROBOT_LOG(level, ...)                                                                                          \
+    do {                                                                                                               \
+        if constexpr (robot::isCompiled(level)) robot::logger().log(level, __VA_ARGS__);                               \
+    } while (0)
+
+/**
+ * @brief Log a structured record with robot::logger(), unless its level is below ROBOT_LOG_LEVEL
+ *
+ * @b Example
+ * @code {.cpp}
+ * ROBOT_RECORD(lemlib::Level::DEBUG, "error: {:.2f}, output: {:.1f}", error, output);
+ * @endcode
+ */
+#define ROBOT_RECORD(level, ...)                                                                                       \
+    do {                                                                                                               \
+        if constexpr (robot::isCompiled(level)) robot::logger().record(level, __VA_ARGS__);                            \
+    } while (0)
+
+namespace robot {
+/** longest message the logger keeps, in characters. Longer messages are cut off */
+constexpr std::size_t LOG_MESSAGE_SIZE = 120;
+
+/**
+ * @brief Check if messages of a level are compiled in. Levels below ROBOT_LOG_LEVEL are compiled out
+ */
+constexpr bool isCompiled(lemlib::Level level) { return int(level) >= ROBOT_LOG_LEVEL; }
+
+/**
+ * @brief Formats the values of a structured record into text
+ *
+ * @param data the format and values, as the logger copied them into the ring buffer
+ * @param out where the text goes, LOG_MESSAGE_SIZE characters
+ * @return the number of characters of text
+ */
+using LogFormatter = std::size_t (*)(const std::uint8_t* data, char* out);
+
+/**
+ * @brief Start of a logged message in the logger's ring buffer
+ */
+struct LogHeader {
+        /** time the message was logged, in milliseconds */
+        std::uint32_t time;
+        lemlib::Level level;
+        /**
+         * nullptr if the text of the message follows. Otherwise the message is a structured record: the format and
+         * values follow, and this turns them into text
+         */
+        LogFormatter formatter;
+};
+
+/**
+ * @brief Logger for control loops, with the same API as LemLib's sinks
+ *
+ * LemLib's BaseSink::log formats every message twice into new strings and copies it into a Message, which is several
+ * heap allocations per line, and its buffer takes a mutex the printing task also holds. This logger formats each
+ * message once on the stack and copies it into a RingBuffer allocated when the logger is created, and a background
+ * task prints the ring. Messages below the lowest level return before anything is formatted. Logging never
+ * allocates, never takes a lock and never waits for the terminal, so it can run at kHz rates inside control loops.
+ *
+ * Structured records go further and copy only the raw values, leaving the formatting to the printing task. Levels
+ * below ROBOT_LOG_LEVEL are compiled out entirely, so competition builds made with "make LOG_LEVEL=2" keep no debug
+ * logging at all. Use ROBOT_LOG and ROBOT_RECORD to skip evaluating the arguments of those calls too.
+ *
+ * When the ring is full, new messages are dropped and counted instead of waiting for room. The printing task reports
+ * how many were dropped.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::logger().setLowestLevel(lemlib::Level::DEBUG);
+ * robot::logger().debug("error: {:.2f}", error);
+ * robot::logger().record(lemlib::Level::DEBUG, "error: {:.2f}, output: {:.1f}", error, output);
+ * @endcode
+ */
+class Logger {
+    public:
+        /**
+         * @brief Construct a new Logger and start its printing task
+         *
+         * @param capacity number of bytes the ring buffer holds. Each message takes about its length plus 16 bytes.
+         * 16384 by default
+         * @param rate time between prints, in milliseconds. 10 by default
+         */
+        Logger(std::size_t capacity = 16384, std::uint32_t rate = 10);
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+        /**
+         * @brief Set the lowest level of messages that are logged. WARN by default, like LemLib's sinks
+         */
+        void setLowestLevel(lemlib::Level level);
+        /**
+         * @return the number of messages dropped because the ring buffer was full
+         */
+        std::uint32_t getDropped() const;
+
+        /**
+         * @brief Log a message at a level
+         *
+         * @param level the level of the message
+         * @param format the format of the message. Use "{}" as placeholders
+         * @param args the values substituted into the placeholders
+         */
+        template <typename... T> void log(lemlib::Level level, fmt::format_string<T...> format, T&&... args) {
+            if (!isCompiled(level) || level < lowestLevel) return;
+            char text[LOG_MESSAGE_SIZE];
+            const auto result = fmt::format_to_n(text, LOG_MESSAGE_SIZE, format, std::forward<T>(args)...);
+            write(level, text, std::min(result.size, LOG_MESSAGE_SIZE));
+        }
+
+        template <typename... T> void debug(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiled(lemlib::Level::DEBUG)) log(lemlib::Level::DEBUG, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void info(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiled(lemlib::Level::INFO)) log(lemlib::Level::INFO, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void warn(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiled(lemlib::Level::WARN)) log(lemlib::Level::WARN, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void error(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiled(lemlib::Level::ERROR)) log(lemlib::Level::ERROR, format, std::forward<T>(args)...);
+        }
+
+        template <typename... T> void fatal(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiled(lemlib::Level::FATAL)) log(lemlib::Level::FATAL, format, std::forward<T>(args)...);
+        }
+
+        /**
+         * @brief Log a structured record at a level
+         *
+         * The values are copied as they are, and formatted later by the printing task. That makes this much cheaper
+         * than log, but the format has to be a string literal since it is read later too.
+         *
+         * @param level the level of the record
+         * @param format the format of the message, a string literal. Use "{}" as placeholders
+         * @param values the values substituted into the placeholders: numbers, bools or enums
+         */
+        template <typename... T> void record(lemlib::Level level, fmt::format_string<T...> format, const T&... values) {
+            static_assert(((std::is_arithmetic_v<T> || std::is_enum_v<T>) && ...),
+                          "records can only hold numbers, bools and enums, anything else may change before printing");
+            if (!isCompiled(level) || level < lowestLevel) return;
+            const fmt::string_view text = format.get();
+            const std::size_t size = sizeof(text) + (sizeof(T) + ... + 0);
+            std::uint8_t* const body = reserve(level, &formatRecord<T...>, size);
+            if (body == nullptr) return;
+            std::uint8_t* data = body;
+            std::memcpy(data, &text, sizeof(text));
+            data += sizeof(text);
+            ((std::memcpy(data, &values, sizeof(T)), data += sizeof(T)), ...);
+            commit(body, size);
+        }
+    private:
+        /**
+         * @brief Format a structured record with values of types T, in the printing task
+         */
+        template <typename... T> static std::size_t formatRecord(const std::uint8_t* data, char* out) {
+            fmt::string_view format;
+            std::memcpy(&format, data, sizeof(format));
+            data += sizeof(format);
+            std::tuple<T...> values;
+            std::apply([&](T&... value) { ((std::memcpy(&value, data, sizeof(T)), data += sizeof(T)), ...); }, values);
+            const auto result = std::apply(
+                [&](const T&... value) {
+                    return fmt::format_to_n(out, LOG_MESSAGE_SIZE, fmt::runtime(format), value...);
+                },
+                values);
+            return std::min(result.size, LOG_MESSAGE_SIZE);
+        }
+
+        /**
+         * @brief Copy a formatted message into the ring buffer
+         */
+        void write(lemlib::Level level, const char* text, std::size_t length);
+        /**
+         * @brief Claim space for a message and write its header
+         *
+         * @param size number of bytes after the header
+         * @return std::uint8_t* to write the rest of the message into. nullptr if the ring buffer is full
+         */
+        std::uint8_t* reserve(lemlib::Level level, LogFormatter formatter, std::size_t size);
+        /**
+         * @brief Hand a message to the printing task
+         *
+         * @param body what reserve returned
+         * @param size the size passed to reserve
+         */
+        void commit(std::uint8_t* body, std::size_t size);
+        /**
+         * @brief Print every written message, oldest first
+         */
+        void flush();
+
+        RingBuffer ring;
+        std::uint32_t rate;
+        lemlib::Level lowestLevel = lemlib::Level::WARN;
+        /** dropped messages the printing task already reported */
+        std::uint32_t reportedDropped = 0;
+        pros::Task task;
+};
+
+/**
+ * @brief Get the logger, created the first time this is called
+ */
+Logger& logger();
+} // namespace robot
@@ -0,0 +1,124 @@
+#pragma once
+
+namespace robot {
+/**
+ * @brief Limits a motion profile has to respect
+ */
+struct ProfileConstraints {
+        /** fastest the robot may move, in inches per second. 0 for the drivetrain's top speed */
+        float maxVelocity = 0;
+        /** fastest the robot may speed up or slow down, in inches per second squared */
+        float maxAcceleration = 120;
+        /** fastest the acceleration may change, in inches per second cubed. 0 for a trapezoidal profile */
+        float maxJerk = 1200;
+};
+
+/**
+ * @brief A point along a motion profile
+ */
+struct ProfileState {
+        /** distance from the start, in inches */
+        float position;
+        /** velocity, in inches per second */
+        float velocity;
+        /** acceleration, in inches per second squared */
+        float acceleration;
+};
+
+/**
+ * @brief Jerk-limited S-curve velocity profile
+ *
+ * The profile changes from the start velocity to a peak velocity, cruises, then changes to the end velocity. Each
+ * change ramps the acceleration up and down at the jerk limit, so the robot doesn't jolt at the start and end of each
+ * phase and the wheels don't slip. Moves too short to reach the velocity or acceleration limit peak lower, so the
+ * profile is as fast as the limits allow for any distance. A non-zero start or end velocity lets a profile pick up
+ * where the last motion left off, or hand off to the next one without stopping.
+ *
+ * Everything is computed when the profile is created, sampling it is a handful of multiplications.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // 48 inches at up to 60in/s, 120in/s^2 and 1200in/s^3
+ * robot::MotionProfile profile(48, {60, 120, 1200});
+ * // where the robot should be after half a second
+ * robot::ProfileState state = profile.sample(0.5);
+ * @endcode
+ */
+class MotionProfile {
+    public:
+        /**
+         * @brief Plan a profile
+         *
+         * The start and end velocities are clamped to maxVelocity. If the distance is too short to reach the end
+         * velocity, the profile ends as close to it as it can.
+         *
+         * @param distance distance to travel, in inches. Negative distances are travelled backwards
+         * @param constraints limits of the profile. maxVelocity must be set
+         * @param startVelocity speed at the start in the direction of travel, in inches per second. 0 by default
+         * @param endVelocity speed at the end in the direction of travel, in inches per second. 0 by default
+         */
+        MotionProfile(float distance, ProfileConstraints constraints, float startVelocity = 0, float endVelocity = 0);
+        /**
+         * @brief Get where the profile is at a time
+         *
+         * @param time time since the start of the profile, in seconds. Times past the end continue at the end
+         * velocity
+         * @return ProfileState
+         */
+        ProfileState sample(float time) const;
+        /**
+         * @return how long the profile takes, in seconds
+         */
+        float getDuration() const;
+        /**
+         * @return the distance the profile travels, in inches
+         */
+        float getDistance() const;
+        /**
+         * @return the velocity the profile ends at, in inches per second. Negative for negative distances, like the
+         * velocities from sample
+         */
+        float getEndVelocity() const;
+    private:
+        /**
+         * @brief A jerk-limited change from one velocity to another
+         */
+        struct Ramp {
+                float startVelocity;
+                float endVelocity;
+                /** length of each jerk phase, in seconds */
+                float jerkTime;
+                /** length of the whole change, in seconds */
+                float duration;
+                /** highest acceleration reached, in inches per second squared */
+                float peakAcceleration;
+
+                /**
+                 * @return the distance the change takes, in inches
+                 */
+                float distance() const;
+        };
+
+        /**
+         * @brief Plan the fastest change between two velocities
+         */
+        Ramp ramp(float from, float to) const;
+        /**
+         * @brief Sample a ramp, forwards
+         */
+        ProfileState sample(const Ramp& ramp, float time) const;
+        /**
+         * @brief Get the speed the profile ends at, forwards
+         */
+        float endSpeed() const;
+
+        float distance;
+        float direction;
+        float acceleration;
+        float jerk;
+        Ramp speedUp;
+        Ramp slowDown;
+        /** length of the constant velocity phase, in seconds */
+        float cruiseTime = 0;
+};
+} // namespace robot
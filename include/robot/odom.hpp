@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "pros/gps.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "robot/integration.hpp"
+#include "robot/poseFilter.hpp"
+
+namespace robot {
+/** number of updates kept in the pose history, about 5 seconds at the default period */
+constexpr std::size_t POSE_HISTORY_SIZE = 512;
+
+/**
+ * @brief How the odometry task integrates the sensors
+ */
+enum class OdomMode {
+    /** call lemlib::update(), which integrates the latest reading of every sensor */
+    LEMLIB,
+    /** resample every sensor at one common instant before integrating, using the sample timestamps */
+    ALIGNED
+};
+
+/**
+ * @brief Timing statistics of the odometry task
+ *
+ * Times are measured with pros::micros(). Jitter is how late a loop started compared to when it was scheduled.
+ */
+struct OdomStats {
+        /** target period of the odometry loop, in milliseconds */
+        std::uint32_t period = 0;
+        /** number of completed loops */
+        std::uint32_t loops = 0;
+        /** execution time of the last update, in microseconds */
+        std::uint32_t lastExecution = 0;
+        /** longest execution time of an update, in microseconds */
+        std::uint32_t maxExecution = 0;
+        /** mean execution time of an update, in microseconds */
+        float meanExecution = 0;
+        /** largest delay between the scheduled and the actual start of a loop, in microseconds */
+        std::uint32_t maxJitter = 0;
+        /** number of loops that were still running when the next loop was due */
+        std::uint32_t overruns = 0;
+};
+
+/**
+ * @brief Set the odometry sensors and start the odometry task
+ *
+ * The task updates odometry at a fixed rate using absolute delay_until scheduling, so the period doesn't stretch by
+ * the time each update takes. When an update overruns its period the missed loops are skipped rather than run back
+ * to back, and the overrun is counted. Calling this again only changes the sensors and the period.
+ *
+ * The sensors are passed on to lemlib::setSensors, so the vertical tracking wheels must not be null.
+ *
+ * @param sensors the sensors to be used
+ * @param drivetrain the drivetrain to be used
+ * @param period time between updates, in milliseconds. 10 by default
+ */
+void initOdom(lemlib::OdomSensors sensors, lemlib::Drivetrain drivetrain, std::uint32_t period = 10);
+
+/**
+ * @brief Set how the odometry task integrates the sensors
+ *
+ * Only the motors report when their sample was taken, and every smart device samples on its own schedule, so the
+ * latest readings of different sensors can be up to a data period apart. In ALIGNED mode every sensor keeps a short
+ * sample history, and all of them are interpolated to the newest instant every sensor has reached before the arc
+ * is integrated. Rotation sensors and the IMU don't report timestamps, so their sample times are estimated from when
+ * their readings change. The pose lags by up to one data period, but heading and displacement always describe the
+ * same motion.
+ *
+ * The pose is published with lemlib::setPose, so everything reading the pose through LemLib sees it, and poses set
+ * with lemlib::setPose or Chassis::setPose are picked up. lemlib::getSpeed is only updated in LEMLIB mode.
+ *
+ * @param mode the odometry mode. LEMLIB by default
+ *
+ * @b Example
+ * @code {.cpp}
+ * void initialize() {
+ *     chassis.calibrate();
+ *     robot::setOdomMode(robot::OdomMode::ALIGNED);
+ * }
+ * @endcode
+ */
+void setOdomMode(OdomMode mode);
+
+/**
+ * @brief Set how ALIGNED mode turns each odometry step into a change in pose
+ *
+ * RUNGE_KUTTA needs an IMU, and falls back to EXPONENTIAL without one. LEMLIB mode always uses LemLib's own update.
+ *
+ * @param integrator the integrator. EXPONENTIAL by default
+ *
+ * @b Example
+ * @code {.cpp}
+ * void initialize() {
+ *     // RK4 keeps odometry as accurate at 20ms as the default integrator at 10ms
+ *     chassis.calibrate(true, 20);
+ *     robot::setOdomMode(robot::OdomMode::ALIGNED);
+ *     robot::setOdomIntegrator(robot::Integrator::RUNGE_KUTTA);
+ * }
+ * @endcode
+ */
+void setOdomIntegrator(Integrator integrator);
+
+/**
+ * @brief Get how the odometry task integrates the sensors
+ *
+ * @return OdomMode
+ */
+OdomMode getOdomMode();
+
+/**
+ * @brief Set the GPS sensor used to correct odometry
+ *
+ * Every odometry update feeds a robot::PoseFilter, which tracks how uncertain the pose has become. When the GPS
+ * reports a new fix with an error below maxError, the filter weighs it against the odometry pose and the corrected
+ * pose is published with lemlib::setPose. Fixes that disagree too much with odometry are rejected.
+ *
+ * The GPS reports the position of the field-centered frame in meters, so LemLib poses must be field-centered too,
+ * with the origin in the middle of the field. Use pros::Gps::set_offset so the GPS reports the tracking center.
+ *
+ * @param gps the GPS sensor, or nullptr to stop using it
+ * @param maxError largest error the GPS may report for its fix to be used, in meters. 0.05 by default
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Gps gps(4, 0, -0.12);
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     robot::setGps(&gps);
+ * }
+ * @endcode
+ */
+void setGps(pros::Gps* gps, float maxError = 0.05);
+
+/**
+ * @brief Get the covariance of the pose
+ *
+ * The covariance grows as the robot moves and shrinks when a GPS fix is used. Setting the pose with
+ * lemlib::setPose or Chassis::setPose resets it.
+ *
+ * @return PoseCovariance x, y and theta in inches and radians
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::PoseCovariance covariance = robot::getPoseCovariance();
+ * printf("x std dev: %f in\n", std::sqrt(covariance[0][0]));
+ * @endcode
+ */
+PoseCovariance getPoseCovariance();
+
+/**
+ * @brief Nudge the pose of the robot
+ *
+ * The correction is added by the odometry task right after its next update, so it can't be lost to an update that
+ * was running at the same time, like a lemlib::setPose from another task could. Corrections made before the next
+ * update add up. Unlike setting the pose, corrections don't reset the pose covariance.
+ *
+ * @param correction change in x, y and theta
+ * @param radians true if theta is in radians, false if in degrees. false by default
+ */
+void correctPose(lemlib::Pose correction, bool radians = false);
+
+/**
+ * @brief Get the pose of the robot at an earlier time
+ *
+ * The odometry task records the pose and velocity after every update in a ring buffer that holds the last
+ * POSE_HISTORY_SIZE updates. Readers never block the odometry task. The pose is interpolated between the two
+ * updates around the timestamp. Timestamps older than the history return the oldest pose, and timestamps newer than
+ * the last update return the latest pose.
+ *
+ * In ALIGNED mode each pose is recorded at the instant the sensors were resampled at, instead of when the update
+ * ran, so it lines up with sensor samples.
+ *
+ * @param timestamp time to get the pose at, in milliseconds since the program started
+ * @param radians true for theta in radians, false for degrees. false by default
+ * @return lemlib::Pose
+ *
+ * @b Example
+ * @code {.cpp}
+ * // the distance sensor reading is about 30ms old, so correct the pose the robot had back then
+ * lemlib::Pose then = robot::getPoseAt(pros::millis() - 30);
+ * @endcode
+ */
+lemlib::Pose getPoseAt(std::uint32_t timestamp, bool radians = false);
+
+/**
+ * @brief Get the velocity of the robot at an earlier time
+ *
+ * Uses the same history as getPoseAt. The velocity is in the global frame, in inches per second and degrees (or
+ * radians) per second. It only comes from the tracking wheels and the IMU, so corrections from the GPS,
+ * correctPose or setPose never show up in it.
+ *
+ * @param timestamp time to get the velocity at, in milliseconds since the program started
+ * @param radians true for theta in radians, false for degrees. false by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose getSpeedAt(std::uint32_t timestamp, bool radians = false);
+
+/**
+ * @brief Get the timing statistics of the odometry task
+ *
+ * @return OdomStats
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::OdomStats stats = robot::getOdomStats();
+ * printf("odom: %lu loops, max jitter %lu us, %lu overruns\n", stats.loops, stats.maxJitter, stats.overruns);
+ * @endcode
+ */
+OdomStats getOdomStats();
+
+/**
+ * @brief Reset the timing statistics of the odometry task, keeping the period
+ */
+void resetOdomStats();
+} // namespace robot
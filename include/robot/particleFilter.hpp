@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace robot {
+/**
+ * @brief A wall or field element edge the distance sensors can see, in inches
+ *
+ * Segments must be vertical (x0 == x1) or horizontal (y0 == y1). Other segments are ignored.
+ */
+struct MapSegment {
+        float x0;
+        float y0;
+        float x1;
+        float y1;
+};
+
+/**
+ * @brief A distance beam mounted on the robot
+ *
+ * Offsets are measured from the tracking center, with +x to the right of the robot and +y to the front.
+ */
+struct BeamMount {
+        /** offset to the right of the tracking center, in inches */
+        float x;
+        /** offset to the front of the tracking center, in inches */
+        float y;
+        /** direction the beam faces relative to the front of the robot, clockwise in degrees */
+        float angle;
+};
+
+/**
+ * @brief Monte Carlo localization with distance beams against a map of segments
+ *
+ * The particles are stored as a structure of arrays, so the ray casting in correct() runs 4 particles at a time with
+ * NEON on the V5 brain (and as plain loops elsewhere). The particle count is rounded up to a multiple of 4.
+ *
+ * This class doesn't use PROS or LemLib, so it can be built and benchmarked on a computer. Poses follow the LemLib
+ * convention: theta is in radians, measured clockwise from the +y axis.
+ */
+class ParticleFilter {
+    public:
+        /**
+         * @brief The weighted mean of the particles
+         */
+        struct Estimate {
+                float x;
+                float y;
+                float theta;
+        };
+
+        /**
+         * @brief Construct a new Particle Filter
+         *
+         * @param map the segments the beams can hit
+         * @param beams the distance beams, in the order their readings are passed to correct()
+         * @param count number of particles. 512 by default
+         * @param seed seed of the random number generator. 1 by default
+         */
+        ParticleFilter(std::vector<MapSegment> map, std::vector<BeamMount> beams, std::size_t count = 512,
+                       std::uint32_t seed = 1);
+        /**
+         * @brief Spread the particles around a pose
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @param theta heading, in radians
+         * @param spread standard deviation of the position, in inches. 1 by default
+         * @param thetaSpread standard deviation of the heading, in radians. 0.02 by default
+         */
+        void reset(float x, float y, float theta, float spread = 1, float thetaSpread = 0.02);
+        /**
+         * @brief Move every particle by an odometry step, with noise
+         *
+         * The step is given in the robot's frame, so each particle moves along its own heading
+         *
+         * @param forward distance moved forwards, in inches
+         * @param right distance moved to the right, in inches
+         * @param turn change in heading, in radians
+         */
+        void predict(float forward, float right, float turn);
+        /**
+         * @brief Weigh the particles by how well they explain the beam readings, and resample them if needed
+         *
+         * @param ranges one reading per beam, in inches. NaN for beams without a usable reading
+         * @return the effective number of particles before resampling. Low values mean the readings were surprising
+         */
+        float correct(const float* ranges);
+        /**
+         * @return the weighted mean of the particles
+         */
+        Estimate estimate() const;
+        /**
+         * @return the number of particles
+         */
+        std::size_t size() const;
+    private:
+        /**
+         * @brief Cast one beam from every particle, writing the distance to the nearest segment into expected
+         */
+        void castBeam(const BeamMount& beam);
+        void resample();
+        /** uniform random number from 0 to 1 */
+        float uniform();
+        /** normally distributed random number with a standard deviation of 1 */
+        float gaussian();
+
+        std::vector<MapSegment> verticalSegments;
+        std::vector<MapSegment> horizontalSegments;
+        std::vector<BeamMount> beams;
+        std::size_t count;
+        std::uint32_t random;
+
+        // particles
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> theta;
+        std::vector<float> sinTheta;
+        std::vector<float> cosTheta;
+        std::vector<float> weight;
+
+        // scratch space, so updates don't allocate
+        std::vector<float> sensorX;
+        std::vector<float> sensorY;
+        std::vector<float> directionX;
+        std::vector<float> directionY;
+        std::vector<float> inverseX;
+        std::vector<float> inverseY;
+        std::vector<float> expected;
+        std::vector<float> resampledX;
+        std::vector<float> resampledY;
+        std::vector<float> resampledTheta;
+};
+} // namespace robot
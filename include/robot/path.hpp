@@ -0,0 +1,336 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "lemlib/asset.hpp"
+
+namespace robot {
+/**
+ * @brief A point of a path, with everything a follower needs precomputed
+ */
+struct PathPoint {
+        /** x position, in inches */
+        float x;
+        /** y position, in inches */
+        float y;
+        /** speed limit from the path file, in motor power from 0 to 127 */
+        float speed;
+        /** curvature, in 1 / inches. Positive curves clockwise */
+        float curvature;
+        /** distance along the path from the first point, in inches */
+        float distance;
+};
+
+/**
+ * @brief Read a path in the format LemLib's follow uses
+ *
+ * The format is what path.jerryio.com exports for LemLib: one "x, y, speed" line per point, ending with "endData".
+ * Repeated points are dropped, and so is everything after the first point with a speed of 0, which is only there for
+ * pure pursuit's lookahead to aim past the end.
+ *
+ * @param path the path asset
+ * @return std::vector<PathPoint> with curvature and distance filled in
+ */
+std::vector<PathPoint> parsePath(const asset& path);
+
+/**
+ * @brief Fill in the curvature and distance of path points
+ *
+ * @param points the points, with x, y and speed set
+ */
+void measurePath(std::vector<PathPoint>& points);
+
+/** first 4 bytes of a binary path, "PTH1" */
+constexpr std::uint32_t PATH_MAGIC = 0x31485450;
+
+/**
+ * @brief Header of a binary path. The points follow it as packed PathPoint records
+ */
+struct PathHeader {
+        /** PATH_MAGIC */
+        std::uint32_t magic;
+        /** number of points */
+        std::uint32_t count;
+};
+
+static_assert(sizeof(PathPoint) == 5 * sizeof(float), "binary paths are PathPoint records without padding");
+static_assert(sizeof(PathHeader) % alignof(PathPoint) == 0, "the points of binary paths must stay aligned");
+
+/**
+ * @brief Points of a path that live somewhere else, like a binary path asset or a parsed path
+ *
+ * Only a pointer and a count, so it is cheap to copy and never allocates.
+ */
+class PathView {
+    public:
+        /**
+         * @brief Construct an empty Path View
+         */
+        PathView() = default;
+        /**
+         * @brief Construct a new Path View over points
+         *
+         * @param points the points, which must outlive the view
+         * @param count number of points
+         */
+        PathView(const PathPoint* points, std::size_t count);
+        /**
+         * @brief View the points of a binary path
+         *
+         * @param data the binary path, aligned to 4 bytes
+         * @param size size of the binary path, in bytes
+         * @return PathView. Empty if the data isn't a binary path
+         */
+        static PathView fromBinary(const void* data, std::size_t size);
+        /**
+         * @return the number of points
+         */
+        std::size_t size() const;
+        /**
+         * @return the point at an index
+         */
+        const PathPoint& operator[](std::size_t index) const;
+    private:
+        const PathPoint* points = nullptr;
+        std::size_t count = 0;
+};
+
+/**
+ * @brief Declare a path converted to binary at build time
+ *
+ * The build converts every path in static/ to bin/paths/name.path, with curvature and distance already computed,
+ * and links it in aligned. PATH_ASSET(name) declares the robot::PathView name_path over it, which the followers read
+ * directly: there's nothing to parse and nothing allocated at auton start.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // static/example.txt
+ * PATH_ASSET(example);
+ *
+ * void autonomous() { chassis.followProfiled(example_path, 4000); }
+ * @endcode
+ */
+#define PATH_ASSET(x)                                                                                                  \
+    extern "C" {                                                                                                       \
+    extern const std::uint8_t _binary_##x##_path_start[], _binary_##x##_path_size[];                                  \
+    }                                                                                                                  \
+    static const robot::PathView x##_path =                                                                            \
+        robot::PathView::fromBinary(_binary_##x##_path_start, (std::size_t)_binary_##x##_path_size)
+
+/**
+ * @brief Finds the closest point and the lookahead point of a path in constant time
+ *
+ * A path is followed from start to end, so both searches keep a cursor that only moves forwards:
+ *
+ * - the closest point is only looked for in a window of path ahead of the last one, since the robot can't travel
+ *   further along the path than that between two searches
+ * - the lookahead point is found by its distance along the path, which the points already store, by walking the
+ *   cursor forwards to the segment that contains it
+ *
+ * Each search costs the few segments in the window instead of the whole path, no matter how long the path is.
+ *
+ * @b Example
+ * @code {.cpp}
+ * PATH_ASSET(example);
+ *
+ * robot::PathIndex index(example_path);
+ * const robot::PathIndex::Projection closest = index.closest(pose.x, pose.y);
+ * const robot::PathPoint lookahead = index.at(closest.distance + 15);
+ * @endcode
+ */
+class PathIndex {
+    public:
+        /**
+         * @brief The point of a path closest to a position
+         */
+        struct Projection {
+                /** index of the first point of the segment the closest point is on */
+                std::size_t segment;
+                /** distance along the path, in inches */
+                float distance;
+                float x;
+                float y;
+        };
+
+        /**
+         * @brief Construct a new Path Index
+         *
+         * @param points the path, which must outlive the index
+         * @param window how much further along the path the closest point may be than the last one, in inches. 12 by
+         * default
+         */
+        PathIndex(PathView points, float window = 12);
+        /**
+         * @brief Find the point of the path closest to a position
+         *
+         * Never returns a point before the last closest point, so the robot can't skip back to an earlier part of a
+         * path that crosses itself.
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @return Projection
+         */
+        Projection closest(float x, float y);
+        /**
+         * @brief Get the point at a distance along the path
+         *
+         * Fastest when the distance increases from one call to the next.
+         *
+         * @param distance distance along the path, in inches. Clamped to the path
+         * @return PathPoint interpolated between the points around it
+         */
+        PathPoint at(float distance);
+        /**
+         * @brief Move both searches back to the start of the path
+         */
+        void reset();
+    private:
+        PathView points;
+        float window;
+        /** segment of the last closest point */
+        std::size_t closestSegment = 0;
+        /** segment of the last point found by distance */
+        std::size_t cursor = 0;
+};
+
+/**
+ * @brief Limits of a path velocity profile
+ */
+struct PathConstraints {
+        /** fastest the robot may move, in inches per second */
+        float maxVelocity;
+        /** fastest the robot may speed up or slow down, in inches per second squared */
+        float maxAcceleration;
+        /** fastest the robot may accelerate sideways in turns, in inches per second squared */
+        float maxLateralAcceleration;
+        /** track width of the drivetrain, so the outer wheel in turns stays under maxVelocity, in inches */
+        float trackWidth;
+};
+
+/**
+ * @brief Time-optimal velocity profile along a path
+ *
+ * Every point has a speed limit: the path's own speed, the outer wheel staying under the top speed, and the sideways
+ * acceleration in turns. The profile moves along the path as fast as those limits allow, speeding up at the
+ * acceleration limit and slowing down just in time to reach the next limits and the end velocity. It starts and ends
+ * at rest unless told otherwise, so it can pick up from and hand off to other motions without stopping.
+ *
+ * The profile is integrated as time goes on instead of planned ahead, so it doesn't allocate anything. Slowing down
+ * only depends on the points within braking distance, so each step looks at a window of a few points ahead.
+ *
+ * Poses follow the LemLib convention: theta is in radians, measured clockwise from the +y axis.
+ *
+ * @b Example
+ * @code {.cpp}
+ * PATH_ASSET(example);
+ *
+ * robot::PathProfile profile(example_path, {60, 120, 80, 12.5});
+ * // where the robot should be after a second
+ * robot::PathProfile::State target = profile.sample(1);
+ * @endcode
+ */
+class PathProfile {
+    public:
+        /**
+         * @brief Where the robot should be at a time, and how it should be moving
+         */
+        struct State {
+                float x;
+                float y;
+                /** direction of the path, in radians */
+                float theta;
+                /** velocity, in inches per second */
+                float velocity;
+                /** angular velocity, in radians per second clockwise */
+                float angularVelocity;
+                /** acceleration, in inches per second squared */
+                float acceleration;
+        };
+
+        /**
+         * @brief Start a profile along a path
+         *
+         * @param points the path, which must outlive the profile
+         * @param constraints limits of the profile
+         * @param startVelocity velocity at the start of the path, in inches per second. 0 by default
+         * @param endVelocity velocity at the end of the path, in inches per second. 0 by default
+         */
+        PathProfile(PathView points, PathConstraints constraints, float startVelocity = 0, float endVelocity = 0);
+        /**
+         * @brief Get the target at a time
+         *
+         * Times must not decrease from one call to the next. Earlier times return the latest target again.
+         *
+         * @param time time since the start of the profile, in seconds
+         * @return State
+         */
+        State sample(float time);
+        /**
+         * @return whether the profile reached the end of the path
+         */
+        bool isDone() const;
+        /**
+         * @return the distance along the path the profile reached, in inches
+         */
+        float getDistance() const;
+        /**
+         * @return the number of points in the path
+         */
+        std::size_t size() const;
+    private:
+        /**
+         * @brief Get the fastest velocity at the current distance that can still slow down for every point ahead
+         */
+        float limit() const;
+        /**
+         * @brief Get the speed limit of a point on its own
+         */
+        float pointLimit(std::size_t index) const;
+        /**
+         * @brief Get the direction of the path at a point, halfway between the segments on either side
+         */
+        float heading(std::size_t index) const;
+
+        PathView points;
+        PathConstraints constraints;
+        /** velocity at the end of the path, in inches per second */
+        float endVelocity;
+        /** segment the profile is in */
+        std::size_t segment = 0;
+        /** distance along the path, in inches */
+        float distance = 0;
+        float velocity = 0;
+        float acceleration = 0;
+        /** time the profile has been integrated to, in seconds */
+        float time = 0;
+};
+
+/**
+ * @brief Velocity and angular velocity of a differential drive
+ */
+struct ChassisSpeeds {
+        /** velocity, in inches per second */
+        float velocity;
+        /** angular velocity, in radians per second clockwise */
+        float angularVelocity;
+};
+
+/**
+ * @brief RAMSETE controller: the speeds that bring the robot back onto a moving target
+ *
+ * Feeds the target's speeds forward and corrects the error between the robot and the target in the robot's frame.
+ * Unlike pure pursuit, the robot tracks where it should be at each moment instead of chasing a point ahead of it, so
+ * there's no lookahead to trade corner cutting against speed. Converges for any error as long as the gains are
+ * positive.
+ *
+ * @param target where the robot should be and how it should be moving
+ * @param x x position of the robot, in inches
+ * @param y y position of the robot, in inches
+ * @param theta heading of the robot, in radians
+ * @param b how aggressively to correct errors, in rad^2/m^2 like the paper, so the usual 2 works. Larger is firmer
+ * @param zeta damping, from 0 to 1. The usual 0.7 works
+ * @return ChassisSpeeds
+ */
+ChassisSpeeds ramsete(const PathProfile::State& target, float x, float y, float theta, float b, float zeta);
+} // namespace robot
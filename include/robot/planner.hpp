@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "robot/path.hpp"
+
+namespace robot {
+/**
+ * @brief A field element the robot must drive around, as an axis-aligned box in inches
+ *
+ * Round elements like goals can be given as the box around them.
+ */
+struct Obstacle {
+        float x0;
+        float y0;
+        float x1;
+        float y1;
+};
+
+/**
+ * @brief Settings of a PathPlanner
+ */
+struct PlannerSettings {
+        /** spacing of the search lattice, in inches. Smaller finds tighter gaps but searches longer. 3 by default */
+        float resolution = 3;
+        /** closest the tracking center may get to an obstacle or a wall, about half the robot's diagonal, in inches */
+        float clearance = 10;
+        /** spacing of the points of the planned path, in inches. 2 by default, like path.jerryio.com */
+        float spacing = 2;
+        /** speed of the planned path, in motor power from 0 to 127. 100 by default */
+        float speed = 100;
+        /** position of the field walls, the inside of the walls of a standard field with the origin in the middle */
+        float left = -70.2;
+        float right = 70.2;
+        float bottom = -70.2;
+        float top = 70.2;
+};
+
+/**
+ * @brief Plans smooth paths around field elements on the brain, for when the robot has to leave its planned paths
+ *
+ * Planning runs in three steps:
+ *
+ * - A* over a lattice of the field finds the shortest way around the obstacles. Each cell stores its distance to the
+ *   nearest obstacle, computed once when the planner is created, so the search only compares numbers
+ * - the lattice path is pulled tight, keeping only the corners the robot can't drive straight past
+ * - a cubic spline through the corners, leaving along the robot's heading and arriving at the target heading, is
+ *   sampled into path points. Parts of the spline that swing too close to an obstacle get another corner from the
+ *   lattice path, until the whole path is clear
+ *
+ * Every buffer is kept between plans, so planning doesn't allocate once it has planned a path of similar length. On a
+ * computer, sim/bin/plannerBenchmark plans across the whole field in well under a millisecond with the default
+ * settings, which leaves plenty of room on the slower brain.
+ *
+ * This class doesn't use PROS or LemLib, so it can be built and benchmarked on a computer. Poses follow the LemLib
+ * convention: theta is in radians, measured clockwise from the +y axis.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // the ladder in the middle of the field
+ * robot::PathPlanner planner({{-12, -12, 12, 12}});
+ *
+ * void autonomous() {
+ *     const lemlib::Pose pose = chassis.getPose(true);
+ *     const robot::PathView path = planner.plan(pose.x, pose.y, pose.theta, 48, 48, M_PI / 2);
+ *     if (path.size() != 0) chassis.follow(path, 15, 4000, true, false);
+ * }
+ * @endcode
+ */
+class PathPlanner {
+    public:
+        /**
+         * @brief Construct a new Path Planner
+         *
+         * @param obstacles the field elements to drive around
+         * @param settings settings of the planner
+         */
+        PathPlanner(std::vector<Obstacle> obstacles, PlannerSettings settings = {});
+        /**
+         * @brief Plan a path from a pose to a pose
+         *
+         * If the robot starts too close to an obstacle, for example after being pushed into one, the path first
+         * backs away from it.
+         *
+         * @param x x position of the robot, in inches
+         * @param y y position of the robot, in inches
+         * @param theta heading of the robot, in radians
+         * @param targetX x position of the target, in inches
+         * @param targetY y position of the target, in inches
+         * @param targetTheta heading at the target, in radians. NaN to arrive at any heading
+         * @param forwards whether the robot will follow the path forwards. true by default
+         * @return PathView over the planned points, valid until the next plan. Empty if the target can't be reached
+         */
+        PathView plan(float x, float y, float theta, float targetX, float targetY, float targetTheta,
+                      bool forwards = true);
+        /**
+         * @brief Get how far a position is from the nearest obstacle or wall
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @return the distance, in inches. Negative inside an obstacle or outside the walls
+         */
+        float clearanceAt(float x, float y) const;
+    private:
+        /**
+         * @brief Search the lattice, filling cells with the cells of the shortest path from start to goal
+         *
+         * @return whether there is a path
+         */
+        bool search(std::uint32_t start, std::uint32_t goal);
+        /**
+         * @brief Check whether the straight line between two positions stays clear
+         */
+        bool isClear(float x0, float y0, float x1, float y1, float minClearance) const;
+        /**
+         * @brief Get the position of a cell of the lattice path. The first and last are the exact start and target
+         */
+        std::pair<float, float> position(std::size_t index) const;
+        /**
+         * @brief Sample the spline through the corners into path
+         *
+         * @param smooth whether to curve through the corners. Otherwise the corners are joined with straight lines
+         * @return the index of the first corner whose segment isn't clear, or the number of corners if all are
+         */
+        std::size_t sample(bool smooth, float minClearance);
+        /**
+         * @return the lattice cell nearest a position
+         */
+        std::uint32_t cellAt(float x, float y) const;
+        float cellX(std::uint32_t cell) const;
+        float cellY(std::uint32_t cell) const;
+
+        std::vector<Obstacle> obstacles;
+        PlannerSettings settings;
+        std::uint32_t columns;
+        std::uint32_t rows;
+        /** distance from the center of each cell to the nearest obstacle, in inches */
+        std::vector<float> clearances;
+
+        // search state, kept between plans
+        std::vector<float> costs;
+        std::vector<std::uint32_t> parents;
+        std::vector<std::uint32_t> visits;
+        std::uint32_t visit = 0;
+        std::vector<std::pair<float, std::uint32_t>> open;
+
+        // ends of the current plan
+        float startX = 0;
+        float startY = 0;
+        float targetX = 0;
+        float targetY = 0;
+        /** direction of travel at the start and at the target, unit vectors. Zero at the target for any heading */
+        float startDirectionX = 0;
+        float startDirectionY = 0;
+        float targetDirectionX = 0;
+        float targetDirectionY = 0;
+
+        /** cells of the last lattice path, from start to goal */
+        std::vector<std::uint32_t> cells;
+        /** index in cells of each corner of the spline */
+        std::vector<std::size_t> corners;
+        std::vector<PathPoint> path;
+};
+} // namespace robot
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+
+namespace robot {
+/**
+ * @brief 3x3 covariance of a pose, in the order x, y, theta. Units are inches and radians
+ */
+using PoseCovariance = std::array<std::array<float, 3>, 3>;
+
+/**
+ * @brief Extended Kalman filter over the pose of the robot
+ *
+ * Odometry drives the prediction step, and absolute position fixes (like the GPS sensor) correct it. The state is
+ * always 3 dimensional, so every step costs the same handful of 3x3 matrix operations.
+ *
+ * Poses follow the LemLib convention: theta is in radians, measured clockwise from the +y axis.
+ */
+class PoseFilter {
+    public:
+        /**
+         * @brief Construct a new Pose Filter
+         *
+         * @param distanceVariance position variance added per inch travelled, in in^2/in. 0.01 by default
+         * @param turnVariance heading variance added per radian turned, in rad^2/rad. 0.0001 by default
+         * @param driftVariance heading variance added per inch travelled, in rad^2/in. 0.00001 by default
+         */
+        PoseFilter(float distanceVariance = 0.01, float turnVariance = 0.0001, float driftVariance = 0.00001);
+        /**
+         * @brief Set the pose and its uncertainty
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @param theta heading, in radians
+         * @param positionVariance variance of x and y, in in^2. 0.25 by default
+         * @param headingVariance variance of theta, in rad^2. 0.0003 by default (about 1 degree)
+         */
+        void reset(float x, float y, float theta, float positionVariance = 0.25, float headingVariance = 0.0003);
+        /**
+         * @brief Move the pose without changing its uncertainty
+         *
+         * @param deltaX change in x, in inches
+         * @param deltaY change in y, in inches
+         * @param deltaTheta change in heading, in radians
+         */
+        void shift(float deltaX, float deltaY, float deltaTheta);
+        /**
+         * @brief Move the pose by an odometry step
+         *
+         * @param deltaX change in x, in inches
+         * @param deltaY change in y, in inches
+         * @param deltaTheta change in heading, in radians
+         */
+        void predict(float deltaX, float deltaY, float deltaTheta);
+        /**
+         * @brief Correct the pose with an absolute measurement of the full pose
+         *
+         * Measurements too unlikely to be true given the current uncertainty are rejected, so a single bad fix can't
+         * throw the pose off.
+         *
+         * @param x measured x position, in inches
+         * @param y measured y position, in inches
+         * @param theta measured heading, in radians. Doesn't need to be unwrapped
+         * @param positionVariance variance of the measured x and y, in in^2
+         * @param headingVariance variance of the measured heading, in rad^2
+         * @return true the measurement was used
+         * @return false the measurement was rejected
+         */
+        bool correct(float x, float y, float theta, float positionVariance, float headingVariance);
+        /**
+         * @return the x position, in inches
+         */
+        float getX() const;
+        /**
+         * @return the y position, in inches
+         */
+        float getY() const;
+        /**
+         * @return the heading, in radians
+         */
+        float getTheta() const;
+        /**
+         * @return the covariance of the pose
+         */
+        PoseCovariance getCovariance() const;
+    private:
+        float distanceVariance;
+        float turnVariance;
+        float driftVariance;
+        float x = 0;
+        float y = 0;
+        float theta = 0;
+        PoseCovariance covariance {};
+};
+} // namespace robot
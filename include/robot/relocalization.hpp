@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "pros/distance.hpp"
+#include "pros/rtos.hpp"
+#include "robot/particleFilter.hpp"
+
+namespace robot {
+/**
+ * @brief A distance sensor and where it is mounted on the robot
+ *
+ * Offsets are measured from the tracking center, with +x to the right of the robot and +y to the front.
+ */
+struct DistanceMount {
+        /** the distance sensor */
+        pros::Distance* sensor;
+        /** offset to the right of the tracking center, in inches */
+        float x;
+        /** offset to the front of the tracking center, in inches */
+        float y;
+        /** direction the sensor faces relative to the front of the robot, clockwise in degrees */
+        float angle;
+};
+
+/**
+ * @brief Position of the field walls in the odometry frame, in inches
+ *
+ * The defaults are the inside of the walls of a standard field with the origin in the middle
+ */
+struct FieldWalls {
+        float left = -70.2;
+        float right = 70.2;
+        float bottom = -70.2;
+        float top = 70.2;
+};
+
+/**
+ * @brief Get the segments of the field walls, for maps that only have the walls
+ *
+ * @param walls where the field walls are. Standard field with the origin in the middle by default
+ * @return std::vector<MapSegment>
+ */
+std::vector<MapSegment> wallSegments(FieldWalls walls = FieldWalls());
+
+/**
+ * @brief Corrects odometry drift with distance sensors facing the field walls
+ *
+ * Every update, each sensor's beam is traced from the pose the robot had when the sensor sampled to the wall it
+ * should hit. The difference between the expected and the measured distance moves the pose along that wall's normal,
+ * by a fraction of the difference set by the blending rate. Readings are rejected when:
+ *
+ * - the sensor's confidence is below the threshold
+ * - the beam hits the wall at too shallow an angle to be reliable
+ * - the measured distance is out of the sensor's range, or too far from the expected distance, which means the
+ *   beam hit something other than the wall
+ * - the robot is turning too fast for the pose at the sample time to be reliable
+ *
+ * Heading is not corrected.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Distance leftDistance(5);
+ * pros::Distance backDistance(6);
+ * robot::WallRelocalizer relocalizer({{&leftDistance, -6, 2, -90}, {&backDistance, 0, -7, 180}});
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     relocalizer.start();
+ * }
+ * @endcode
+ */
+class WallRelocalizer {
+    public:
+        /**
+         * @brief Construct a new Wall Relocalizer
+         *
+         * @param sensors the distance sensors and their mounting positions
+         * @param walls where the field walls are. Standard field with the origin in the middle by default
+         * @param rate fraction of each correction applied per update, from 0 to 1. 0.2 by default
+         * @param minConfidence lowest confidence a reading may have, from 0 to 63. 45 by default
+         * @param band largest difference between the expected and measured distance, in inches. 4 by default
+         * @param maxIncidence largest angle between the beam and the wall's normal, in degrees. 30 by default
+         */
+        WallRelocalizer(std::vector<DistanceMount> sensors, FieldWalls walls = FieldWalls(), float rate = 0.2,
+                        int minConfidence = 45, float band = 4, float maxIncidence = 30);
+        /**
+         * @brief Correct the pose once with the latest readings
+         *
+         * @return the number of readings that were used
+         */
+        int update();
+        /**
+         * @brief Call update periodically on a background task
+         *
+         * @param period time between updates, in milliseconds. 50 by default, the distance sensor updates about
+         * every 33ms
+         */
+        void start(std::uint32_t period = 50);
+        /**
+         * @brief Stop the background task, waiting for the update it is running to finish
+         */
+        void stop();
+        /**
+         * @return the number of readings used since the relocalizer was created
+         */
+        std::uint32_t getAccepted() const;
+        /**
+         * @return the number of readings rejected since the relocalizer was created
+         */
+        std::uint32_t getRejected() const;
+    private:
+        std::vector<DistanceMount> sensors;
+        FieldWalls walls;
+        float rate;
+        int minConfidence;
+        float band;
+        float minCosine;
+        std::uint32_t accepted = 0;
+        std::uint32_t rejected = 0;
+        pros::Task* task = nullptr;
+        /** the background task runs until stopping is set, and clears running when it exits */
+        std::atomic<bool> running = false;
+        std::atomic<bool> stopping = false;
+};
+
+/**
+ * @brief Localizes the robot with a particle filter over odometry and distance sensors
+ *
+ * A more accurate alternative to WallRelocalizer. Odometry moves the particles, and the distance sensor readings
+ * are compared to the map from every particle to weigh them. Unlike WallRelocalizer, it corrects heading as well,
+ * readings that hit field elements in the map are useful instead of rejected, and a reading that fits a different
+ * wall than expected isn't trusted blindly.
+ *
+ * Every update the odometry pose is moved towards the weighted mean of the particles. Setting the pose, or any
+ * jump of more than a foot between updates, restarts the particles around the new pose.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Distance leftDistance(5);
+ * pros::Distance backDistance(6);
+ * pros::Distance rightDistance(7);
+ * robot::ParticleRelocalizer localizer({{&leftDistance, -6, 2, -90},
+ *                                       {&backDistance, 0, -7, 180},
+ *                                       {&rightDistance, 6, 2, 90}});
+ *
+ * void initialize() {
+ *     chassis.calibrate();
+ *     localizer.start();
+ * }
+ * @endcode
+ */
+class ParticleRelocalizer {
+    public:
+        /**
+         * @brief Construct a new Particle Relocalizer
+         *
+         * @param sensors the distance sensors and their mounting positions
+         * @param map the segments the sensors can see. The field walls by default
+         * @param particles number of particles. 512 by default
+         * @param rate fraction of the difference between odometry and the particles applied per update, from 0 to 1.
+         * 0.5 by default
+         * @param minConfidence lowest confidence a reading may have, from 0 to 63. 30 by default
+         */
+        ParticleRelocalizer(std::vector<DistanceMount> sensors, std::vector<MapSegment> map = wallSegments(),
+                            std::size_t particles = 512, float rate = 0.5, int minConfidence = 30);
+        /**
+         * @brief Move the particles by the odometry since the last update, then weigh them with the latest readings
+         *
+         * Odometry is only pulled towards the particles when at least one reading was used and the readings matched
+         * some of the particles.
+         *
+         * @return the effective number of particles. Values much lower than the particle count mean the readings
+         * didn't match odometry, 0 that they matched none of the particles
+         */
+        float update();
+        /**
+         * @brief Call update periodically on a background task
+         *
+         * @param period time between updates, in milliseconds. 50 by default, the distance sensor updates about
+         * every 33ms
+         */
+        void start(std::uint32_t period = 50);
+        /**
+         * @brief Stop the background task, waiting for the update it is running to finish
+         */
+        void stop();
+    private:
+        std::vector<DistanceMount> sensors;
+        ParticleFilter filter;
+        float rate;
+        int minConfidence;
+        std::vector<float> ranges;
+        bool started = false;
+        /** odometry pose at the last update, theta in radians */
+        float lastX = 0;
+        float lastY = 0;
+        float lastTheta = 0;
+        pros::Task* task = nullptr;
+        /** the background task runs until stopping is set, and clears running when it exits */
+        std::atomic<bool> running = false;
+        std::atomic<bool> stopping = false;
+};
+} // namespace robot
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace robot {
+/**
+ * @brief A record read from a ring buffer
+ */
+struct RingRecord {
+        /** the bytes of the record, nullptr if there is no record */
+        const std::uint8_t* data = nullptr;
+        /** number of bytes */
+        std::size_t size = 0;
+};
+
+/**
+ * @brief Fixed-size ring of variable-length byte records, with any number of writers and one reader
+ *
+ * Writers claim space with a compare-and-swap and never wait: when the ring doesn't have room for a record, the new
+ * record is dropped and counted, and the records already in the ring are kept. The reader takes records in the order
+ * their space was claimed. A record whose writer hasn't committed it yet holds back the records after it until it is
+ * committed.
+ *
+ * Records are 4-byte aligned and start with a 4-byte header. A record that doesn't fit before the end of the ring
+ * starts over at the beginning, and the space it skipped counts towards the record's size when checking for room.
+ *
+ * This class doesn't use PROS or LemLib, so it is built on a computer too: sim/bin/ringBenchmark writes into one ring
+ * from several threads and checks that every writer's records arrive in order and intact, and that the drop count
+ * matches the records that didn't fit.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::RingBuffer ring(4096);
+ * // any task
+ * if (std::uint8_t* data = ring.reserve(sizeof(value))) {
+ *     std::memcpy(data, &value, sizeof(value));
+ *     ring.commit(data, sizeof(value));
+ * }
+ * // one task
+ * for (robot::RingRecord record = ring.front(); record.data != nullptr; record = ring.front()) {
+ *     handle(record.data, record.size);
+ *     ring.pop();
+ * }
+ * @endcode
+ */
+class RingBuffer {
+    public:
+        /**
+         * @brief Construct a new Ring Buffer
+         *
+         * @param capacity number of bytes the ring holds, rounded up to a power of 2
+         */
+        RingBuffer(std::size_t capacity);
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+        /**
+         * @brief Claim space for a record. Never blocks
+         *
+         * @param size number of bytes of the record
+         * @return std::uint8_t* to write the record into, 4-byte aligned. nullptr if the ring is full, and the record
+         * is counted as dropped
+         */
+        std::uint8_t* reserve(std::size_t size);
+        /**
+         * @brief Hand a written record to the reader
+         *
+         * @param data what reserve returned
+         * @param size the size passed to reserve
+         */
+        void commit(std::uint8_t* data, std::size_t size);
+        /**
+         * @brief Get the oldest record, without removing it. Only call from the reader
+         *
+         * @return RingRecord with a nullptr data if there is no committed record
+         */
+        RingRecord front();
+        /**
+         * @brief Remove the record front returned. Only call from the reader
+         */
+        void pop();
+        /**
+         * @return the number of records dropped because the ring was full
+         */
+        std::uint32_t getDropped() const;
+        /**
+         * @return the number of bytes dropped because the ring was full, record headers included
+         */
+        std::uint32_t getDroppedBytes() const;
+        /**
+         * @return the most bytes that were ever claimed and not yet removed at once
+         */
+        std::uint32_t getHighWater() const;
+    private:
+        std::unique_ptr<std::uint32_t[]> words;
+        /** in bytes, a power of 2 */
+        std::uint32_t capacity;
+        /** bytes ever claimed, and ever removed. Offsets in the ring are these modulo the capacity */
+        std::atomic<std::uint32_t> head = 0;
+        std::atomic<std::uint32_t> tail = 0;
+        std::atomic<std::uint32_t> dropped = 0;
+        std::atomic<std::uint32_t> droppedBytes = 0;
+        std::atomic<std::uint32_t> highWater = 0;
+};
+} // namespace robot
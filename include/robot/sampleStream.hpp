@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace robot {
+/**
+ * @brief A short history of timestamped sensor samples that can be resampled at any instant
+ *
+ * Smart devices don't all sample at the same time, and only the motors report when their sample was taken. Samples
+ * from devices that report a timestamp are pushed with it. Samples from devices that don't are polled, and the
+ * stream estimates the sample time from when the value changed.
+ */
+class SampleStream {
+    public:
+        /**
+         * @brief Construct a new Sample Stream
+         *
+         * @param dataRate how often the device produces a new sample, in milliseconds. 10 by default
+         */
+        SampleStream(std::uint32_t dataRate = 10);
+        /**
+         * @brief Clear the history and start from a single sample
+         *
+         * @param value the current value
+         * @param time the current time, in milliseconds
+         */
+        void reset(float value, double time);
+        /**
+         * @brief Add a sample with a timestamp reported by the device
+         *
+         * Samples older than the newest sample are ignored, so pushing the same sample twice is harmless
+         *
+         * @param value the sampled value
+         * @param time the time the sample was taken, in milliseconds
+         */
+        void push(float value, double time);
+        /**
+         * @brief Add a reading from a device that doesn't report timestamps
+         *
+         * A reading that differs from the last one is a new sample taken some time since the previous poll, so it is
+         * stamped halfway between the two polls. A reading that hasn't changed for a whole data period is stamped
+         * with the poll time, since the device must have sampled the same value again.
+         *
+         * @param value the value read from the device
+         * @param now the time of the read, in milliseconds
+         */
+        void poll(float value, double now);
+        /**
+         * @return the time of the newest sample, in milliseconds
+         */
+        double latest() const;
+        /**
+         * @brief Get the value of the stream at an instant
+         *
+         * Interpolates linearly between the two samples around the instant. Instants after the newest sample are
+         * extrapolated from the last two samples by up to one data period, instants before the oldest sample return
+         * the oldest sample.
+         *
+         * @param time the instant, in milliseconds
+         * @return float
+         */
+        float at(double time) const;
+    private:
+        struct Sample {
+                float value = 0;
+                double time = 0;
+        };
+
+        void add(float value, double time);
+
+        std::array<Sample, 4> samples {};
+        std::uint8_t newest = 0;
+        std::uint8_t count = 0;
+        std::uint32_t dataRate;
+        double lastPoll = 0;
+};
+} // namespace robot
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robot {
+/**
+ * Binary telemetry frames
+ *
+ * Every frame is TELEMETRY_SYNC, a frame type byte, the payload length as 2 bytes, the payload, and a CRC-16-CCITT
+ * of the type, length and payload as 2 bytes. Numbers are little endian. Text printed to the same stream between
+ * frames is skipped by the decoder, and so is any frame with a bad CRC.
+ *
+ * The schema frame lists the channels: their count as a byte, then for each channel its TelemetryType as a byte, its
+ * scale as a float, and the length of its name as a byte followed by the name. A sample frame starts with a sequence
+ * number byte that goes up by one every sample and the time as a varint, then has one field per channel. FLOAT
+ * fields are 4-byte floats, SCALED fields are the value times the scale, rounded to an integer, as a zigzag varint.
+ * Key frames hold the time and the values themselves. Delta frames hold the time and the SCALED values as differences
+ * from the previous sample, so a delta frame can only be decoded right after the sample before it.
+ *
+ * A text frame is a logged message: the time as a varint, the level as a byte and the text. A footer frame ends a
+ * recording that was closed properly, with the number of samples and the number of dropped frames as varints.
+ */
+
+/** first 2 bytes of every frame */
+constexpr std::uint8_t TELEMETRY_SYNC[2] = {0xA5, 0x5A};
+/** most channels a schema can have */
+constexpr std::size_t TELEMETRY_MAX_CHANNELS = 64;
+/** longest text a text frame can have, in characters */
+constexpr std::size_t TELEMETRY_MAX_TEXT = 255;
+/** largest a text frame can get, in bytes */
+constexpr std::size_t TELEMETRY_MAX_TEXT_FRAME = 5 + 5 + 1 + TELEMETRY_MAX_TEXT + 2;
+
+/**
+ * @brief Types of frames
+ */
+enum class TelemetryFrame : std::uint8_t { SCHEMA = 1, KEY = 2, DELTA = 3, TEXT = 4, FOOTER = 5 };
+
+/**
+ * @brief How the values of a channel are sent
+ */
+enum class TelemetryType : std::uint8_t {
+    /** as 4-byte floats, for values with a wide range or that must be exact */
+    FLOAT = 0,
+    /** multiplied by the scale and rounded to an integer. Small changes between samples take 1 or 2 bytes */
+    SCALED = 1
+};
+
+/**
+ * @brief A channel of telemetry
+ */
+struct TelemetryChannel {
+        /** name of the channel, the CSV column. At most 255 characters */
+        std::string name;
+        TelemetryType type = TelemetryType::SCALED;
+        /** number the values of SCALED channels are multiplied by. 100 by default, for a resolution of 0.01 */
+        float scale = 100;
+};
+
+/**
+ * @brief Get the CRC-16-CCITT of bytes, the checksum of telemetry frames
+ *
+ * @param data the bytes
+ * @param size number of bytes
+ * @param crc the CRC of the bytes before these ones. 0xFFFF to start
+ * @return std::uint16_t
+ */
+std::uint16_t crc16(const std::uint8_t* data, std::size_t size, std::uint16_t crc = 0xFFFF);
+
+/**
+ * @brief Encode a text frame
+ *
+ * @param time time of the message, in milliseconds
+ * @param level level of the message
+ * @param text the message. Anything past TELEMETRY_MAX_TEXT characters is cut off
+ * @param length number of characters of the message
+ * @param out where the frame goes, at least TELEMETRY_MAX_TEXT_FRAME bytes
+ * @return the size of the frame, in bytes
+ */
+std::size_t encodeTelemetryText(std::uint32_t time, std::uint8_t level, const char* text, std::size_t length,
+                                std::uint8_t* out);
+
+/**
+ * @brief Encode a footer frame
+ *
+ * @param samples number of samples recorded
+ * @param dropped number of frames that were dropped
+ * @param out where the frame goes, at least 17 bytes
+ * @return the size of the frame, in bytes
+ */
+std::size_t encodeTelemetryFooter(std::uint32_t samples, std::uint32_t dropped, std::uint8_t* out);
+
+/**
+ * @brief Turns samples of channels into telemetry frames
+ *
+ * Every keyInterval-th sample is a key frame, so a decoder that joins late or loses a frame catches up within that
+ * many samples. Samples have to be encoded in order and every frame has to reach the decoder, otherwise call
+ * forceKey so the next frame doesn't depend on the lost one.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::TelemetryEncoder encoder({{"x"}, {"y"}, {"theta", robot::TelemetryType::SCALED, 1000}});
+ * std::vector<std::uint8_t> frame(encoder.getMaxSampleSize());
+ * const float values[] = {pose.x, pose.y, pose.theta};
+ * fwrite(frame.data(), 1, encoder.encode(pros::millis(), values, frame.data()), stdout);
+ * @endcode
+ */
+class TelemetryEncoder {
+    public:
+        /**
+         * @brief Construct a new Telemetry Encoder
+         *
+         * @param channels the channels, at most TELEMETRY_MAX_CHANNELS. Any more are left out
+         * @param keyInterval number of samples from one key frame to the next. 100 by default
+         */
+        TelemetryEncoder(std::vector<TelemetryChannel> channels, std::uint32_t keyInterval = 100);
+        /**
+         * @return the schema frame describing the channels
+         */
+        std::vector<std::uint8_t> schema() const;
+        /**
+         * @brief Encode a sample
+         *
+         * @param time time of the sample, in milliseconds
+         * @param values the value of every channel, in order
+         * @param out where the frame goes, at least getMaxSampleSize bytes
+         * @return the size of the frame, in bytes
+         */
+        std::size_t encode(std::uint32_t time, const float* values, std::uint8_t* out);
+        /**
+         * @brief Make the next sample a key frame
+         */
+        void forceKey();
+        /**
+         * @return the largest a sample frame can get, in bytes
+         */
+        std::size_t getMaxSampleSize() const;
+        const std::vector<TelemetryChannel>& getChannels() const;
+    private:
+        std::vector<TelemetryChannel> channels;
+        std::uint32_t keyInterval;
+        /** samples until the next key frame */
+        std::uint32_t untilKey = 0;
+        std::uint8_t sequence = 0;
+        std::uint32_t lastTime = 0;
+        /** last integer sent for every SCALED channel */
+        std::vector<std::int32_t> last;
+};
+
+/**
+ * @brief What TelemetryDecoder::next found
+ */
+enum class TelemetryEvent { NONE, SCHEMA, SAMPLE, TEXT, FOOTER };
+
+/**
+ * @brief A message from a text frame
+ */
+struct TelemetryText {
+        /** time of the message, in milliseconds */
+        std::uint32_t time = 0;
+        /** level of the message, a lemlib::Level number */
+        std::uint8_t level = 0;
+        std::string text;
+};
+
+/**
+ * @brief The contents of a footer frame
+ */
+struct TelemetryFooter {
+        /** number of samples recorded */
+        std::uint32_t samples = 0;
+        /** number of frames that were dropped while recording */
+        std::uint32_t dropped = 0;
+};
+
+/**
+ * @brief Turns a stream of bytes with telemetry frames back into samples
+ *
+ * Bytes that aren't part of a frame are skipped. Delta frames are skipped until a schema and a key frame have been
+ * decoded, and again after a lost frame until the next key frame.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::TelemetryDecoder decoder;
+ * decoder.push(bytes, size);
+ * for (robot::TelemetryEvent event; (event = decoder.next()) != robot::TelemetryEvent::NONE;) {
+ *     if (event == robot::TelemetryEvent::SAMPLE) printf("%u: %f\n", decoder.getTime(), decoder.getValues()[0]);
+ * }
+ * @endcode
+ */
+class TelemetryDecoder {
+    public:
+        /**
+         * @brief Add received bytes
+         */
+        void push(const std::uint8_t* data, std::size_t size);
+        /**
+         * @brief Decode the next frame of the bytes pushed so far
+         *
+         * @return TelemetryEvent::SCHEMA when the channels changed, TelemetryEvent::SAMPLE when there is a new
+         * sample, TelemetryEvent::TEXT when there is a new message, TelemetryEvent::FOOTER at the end of a
+         * recording, TelemetryEvent::NONE when more bytes are needed
+         */
+        TelemetryEvent next();
+        const std::vector<TelemetryChannel>& getChannels() const;
+        /**
+         * @return the time of the last sample, in milliseconds
+         */
+        std::uint32_t getTime() const;
+        /**
+         * @return the values of the last sample, one per channel
+         */
+        const std::vector<float>& getValues() const;
+        /**
+         * @return the last message
+         */
+        const TelemetryText& getText() const;
+        /**
+         * @return the last footer
+         */
+        const TelemetryFooter& getFooter() const;
+        /**
+         * @return the number of frames with a bad CRC or contents
+         */
+        std::uint32_t getCorrupt() const;
+        /**
+         * @return the number of delta frames that couldn't be decoded because a frame before them was lost
+         */
+        std::uint32_t getSkipped() const;
+    private:
+        /**
+         * @brief Decode a frame whose CRC checked out
+         */
+        TelemetryEvent decode(TelemetryFrame type, const std::uint8_t* payload, std::size_t size);
+
+        std::vector<std::uint8_t> buffer;
+        std::vector<TelemetryChannel> channels;
+        std::vector<std::int32_t> last;
+        std::vector<float> values;
+        std::uint8_t sequence = 0;
+        std::uint32_t time = 0;
+        TelemetryText text;
+        TelemetryFooter footer;
+        /** whether the previous sample is known, so delta frames can be decoded */
+        bool synced = false;
+        std::uint32_t corrupt = 0;
+        std::uint32_t skipped = 0;
+};
+} // namespace robot
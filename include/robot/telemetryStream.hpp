@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "robot/ringBuffer.hpp"
+#include "robot/telemetry.hpp"
+
+namespace robot {
+/**
+ * @brief Streams binary telemetry frames over the serial link
+ *
+ * LemLib's TelemetrySink prints every value as text, which at 100 Hz is more than the controller link carries and
+ * has to be parsed on the computer. This sends samples as TelemetryEncoder frames instead: a sample of 16 channels
+ * that changed a little since the last one takes about 35 bytes. Recording a sample encodes it and copies it into a
+ * RingBuffer without waiting, and a background task writes the frames to stdout. The schema frame is sent every
+ * second so a computer can start listening at any time.
+ *
+ * Starting the stream turns off PROS's COBS framing of stdout so the frames go out as they are. Text printed
+ * afterwards still shows up in a plain serial terminal, and sim/tools/decodeTelemetry skips it when converting a
+ * capture of the link to CSV.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::TelemetryStream telemetry({{"x"}, {"y"}, {"theta", robot::TelemetryType::SCALED, 1000}, {"current", 1}});
+ * telemetry.start();
+ * // every 10ms, from one task
+ * telemetry.record({pose.x, pose.y, pose.theta, float(motor.get_current_draw())});
+ * @endcode
+ */
+class TelemetryStream {
+    public:
+        /**
+         * @brief Construct a new Telemetry Stream
+         *
+         * @param channels the channels, at most TELEMETRY_MAX_CHANNELS
+         * @param capacity number of bytes of frames that can wait to be written. 8192 by default
+         */
+        TelemetryStream(std::vector<TelemetryChannel> channels, std::size_t capacity = 8192);
+        TelemetryStream(const TelemetryStream&) = delete;
+        TelemetryStream& operator=(const TelemetryStream&) = delete;
+        /**
+         * @brief Turn off COBS on stdout and start writing frames
+         */
+        void start();
+        /**
+         * @brief Record a sample of every channel, stamped with the current time. Never blocks
+         *
+         * Only call this from one task, since every frame depends on the one before it.
+         *
+         * @param values the value of every channel, in order. Missing values are sent as 0
+         */
+        void record(std::initializer_list<float> values);
+        /**
+         * @return the number of samples dropped because frames were recorded faster than the link sends them
+         */
+        std::uint32_t getDropped() const;
+    private:
+        /**
+         * @brief Write every waiting frame to stdout
+         */
+        void flush();
+
+        TelemetryEncoder encoder;
+        std::vector<std::uint8_t> schema;
+        /** frame being encoded, so recording doesn't allocate */
+        std::vector<std::uint8_t> frame;
+        RingBuffer ring;
+        std::uint32_t lastSchema = 0;
+        std::optional<pros::Task> task;
+};
+} // namespace robot
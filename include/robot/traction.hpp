@@ -0,0 +1,78 @@
+#pragma once
+
+namespace robot {
+/**
+ * @brief Settings of traction control
+ */
+struct TractionSettings {
+        /** slip that counts as slipping, as a fraction of the wheel or ground velocity. 0.2 by default */
+        float threshold = 0.2;
+        /** slowest velocity slip is measured against, in inches per second. 6 by default */
+        float minVelocity = 6;
+        /** fastest the power may change while slipping, in power per second. 300 by default */
+        float slew = 300;
+        /** least power backing off goes down to, so a side pushing a robot or a wall keeps pushing. 20 by default */
+        float minPower = 20;
+};
+
+/**
+ * @brief Detects wheel slip on one side of a drivetrain and limits the power until the wheels grip again
+ *
+ * Slip is the difference between how fast the drive motors turn the wheels and how fast the ground under them
+ * actually moves, which comes from the tracking wheels and the IMU. A side slips when the difference is more than a
+ * fraction of the speed. While a side slips, its power can only change at a limited rate, and when the wheels spin
+ * faster than the ground in the direction they're driven, the power backs off towards what the ground speed takes so
+ * the wheels can grip again, but never below the minimum power. Once the wheels grip, the power rises back to what
+ * was asked for at the same rate instead of jumping, so the wheels don't break loose again right away. Easing off
+ * and releasing the power always take effect right away.
+ *
+ * @b Example
+ * @code {.cpp}
+ * robot::TractionControl left;
+ * // every 10ms
+ * const float power = left.update(requested, wheelVelocity, groundVelocity, feedforward.calculate(groundVelocity),
+ *                                 0.01);
+ * @endcode
+ */
+class TractionControl {
+    public:
+        /**
+         * @brief Construct a new Traction Control
+         *
+         * @param settings settings of the traction control
+         */
+        TractionControl(TractionSettings settings = {});
+        /**
+         * @brief Get the power to send to the side, given the power a motion or the driver asks for
+         *
+         * @param power the power asked for, from -127 to 127
+         * @param wheelVelocity velocity of the wheels from the drive motors' encoders, in inches per second
+         * @param groundVelocity velocity of the ground under the side, in inches per second
+         * @param gripPower power that drives the side at the ground velocity, from the feedforward
+         * @param time time since the last update, in seconds
+         * @return the power to send
+         */
+        float update(float power, float wheelVelocity, float groundVelocity, float gripPower, float time);
+        /**
+         * @brief Forget the past updates, for when the side hasn't been driven for a while
+         */
+        void reset();
+        /**
+         * @return whether the side is slipping
+         */
+        bool isSlipping() const;
+        /**
+         * @return the filtered slip, as a fraction of the faster of the wheel and ground velocity. Positive when the
+         * wheels turn faster forwards than the ground
+         */
+        float getSlip() const;
+    private:
+        TractionSettings settings;
+        float slip = 0;
+        bool slipping = false;
+        /** whether the power is held below what was asked for, from slipping until it catches up */
+        bool limited = false;
+        /** last power sent, from -127 to 127 */
+        float output = 0;
+};
+} // namespace robot
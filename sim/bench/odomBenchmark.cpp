@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "robot/integration.hpp"
+
+/**
+ * Benchmark of the odometry integrators in robot/integration.hpp
+ *
+ * A ground truth path is integrated finely from a velocity and an angular velocity that both keep changing, like a
+ * robot weaving through a skills run. Odometry steps are then taken from the truth at different rates, exactly as
+ * perfect tracking wheels and a perfect IMU would measure them, so the only error left is the integration error.
+ * Reports the final and the worst position error of each integrator after a minute, and the time each step takes.
+ */
+
+namespace {
+constexpr double DURATION = 60;
+/** step of the ground truth, in seconds */
+constexpr double TRUTH_STEP = 0.00005;
+
+double velocity(double t) { return 40 + 20 * std::sin(0.7 * t); }
+
+double angularVelocity(double t) { return 3 * std::sin(1.3 * t) + 1.5 * std::sin(2.9 * t); }
+
+struct Sample {
+        double x;
+        double y;
+        double theta;
+        /** distance travelled since the start */
+        double distance;
+};
+
+/** ground truth, one sample per millisecond */
+std::vector<Sample> truth() {
+    std::vector<Sample> out;
+    double x = 0, y = 0, theta = 0, distance = 0;
+    const int perMillisecond = std::lround(0.001 / TRUTH_STEP);
+    for (long i = 0; i <= long(DURATION / TRUTH_STEP); i++) {
+        if (i % perMillisecond == 0) out.push_back({x, y, theta, distance});
+        // midpoint rule
+        const double t = (i + 0.5) * TRUTH_STEP;
+        const double heading = theta + angularVelocity(t) * TRUTH_STEP / 2;
+        x += velocity(t) * TRUTH_STEP * std::sin(heading);
+        y += velocity(t) * TRUTH_STEP * std::cos(heading);
+        theta += angularVelocity(t) * TRUTH_STEP;
+        distance += velocity(t) * TRUTH_STEP;
+    }
+    return out;
+}
+
+struct Result {
+        double finalError;
+        double maxError;
+        double stepTime;
+};
+
+/**
+ * @param integrator integrator to use, or nullptr for Euler integration along the heading at the start of each step
+ * @param period odometry period, in milliseconds
+ */
+Result run(const std::vector<Sample>& samples, const robot::Integrator* integrator, int period) {
+    robot::IntegratorPose pose = {0, 0, 0};
+    double maxError = 0;
+    std::chrono::duration<double> elapsed(0);
+    int steps = 0;
+    for (std::size_t i = period; i < samples.size(); i += period) {
+        const Sample& before = samples[i - period];
+        const Sample& after = samples[i];
+        const float forward = after.distance - before.distance;
+        const float turn = after.theta - before.theta;
+        const auto start = std::chrono::steady_clock::now();
+        if (integrator == nullptr) {
+            pose.x += forward * std::sin(pose.theta);
+            pose.y += forward * std::cos(pose.theta);
+            pose.theta += turn;
+        } else {
+            robot::integrate(*integrator, pose, forward, 0, turn, angularVelocity((i - period) / 1000.0),
+                             angularVelocity(i / 1000.0), period / 1000.0f);
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+        steps++;
+        // keep the heading from the truth, so heading error doesn't hide the integration error
+        pose.theta = after.theta;
+        maxError = std::max(maxError, std::hypot(pose.x - after.x, pose.y - after.y));
+    }
+    const Sample& last = samples[samples.size() - 1 - (samples.size() - 1) % period];
+    return {std::hypot(pose.x - last.x, pose.y - last.y), maxError, elapsed.count() / steps * 1e9};
+}
+} // namespace
+
+int main() {
+    const std::vector<Sample> samples = truth();
+    const robot::Integrator exponential = robot::Integrator::EXPONENTIAL;
+    const robot::Integrator rungeKutta = robot::Integrator::RUNGE_KUTTA;
+    const struct {
+            const char* name;
+            const robot::Integrator* integrator;
+    } integrators[] = {{"euler", nullptr}, {"exponential", &exponential}, {"runge-kutta", &rungeKutta}};
+
+    std::printf("%10s %12s %16s %14s %10s\n", "period ms", "integrator", "final error in", "max error in",
+                "ns/step");
+    for (const int period : {5, 10, 20, 40, 80}) {
+        for (const auto& integrator : integrators) {
+            const Result result = run(samples, integrator.integrator, period);
+            std::printf("%10d %12s %16.4f %14.4f %10.1f\n", period, integrator.name, result.finalError,
+                        result.maxError, result.stepTime);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "robot/particleFilter.hpp"
+
+/**
+ * Benchmark of robot::ParticleFilter
+ *
+ * The robot drives circles around the middle of a standard field with three distance beams. Odometry drifts, and
+ * the filter corrects it with noisy beam readings against the walls. Reports how many particles per second the
+ * filter updates (one predict and one correct per particle), and the position error at the end of the run.
+ */
+
+namespace {
+constexpr float WALL = 70.2;
+const std::vector<robot::MapSegment> walls = {
+    {-WALL, -WALL, -WALL, WALL}, {WALL, -WALL, WALL, WALL}, {-WALL, -WALL, WALL, -WALL}, {-WALL, WALL, WALL, WALL}};
+const std::vector<robot::BeamMount> beams = {{-6, 2, -90}, {0, -7, 180}, {6, 2, 90}};
+
+/** distance from a beam to the nearest wall, the same way the filter measures it */
+float cast(float x, float y, float theta, const robot::BeamMount& beam) {
+    const float sensorX = x + beam.x * std::cos(theta) + beam.y * std::sin(theta);
+    const float sensorY = y - beam.x * std::sin(theta) + beam.y * std::cos(theta);
+    const float heading = theta + beam.angle * M_PI / 180;
+    const float dx = std::sin(heading);
+    const float dy = std::cos(heading);
+    const float toX = dx > 0 ? (WALL - sensorX) / dx : dx < 0 ? (-WALL - sensorX) / dx : INFINITY;
+    const float toY = dy > 0 ? (WALL - sensorY) / dy : dy < 0 ? (-WALL - sensorY) / dy : INFINITY;
+    return std::min(toX, toY);
+}
+
+struct Result {
+        double particlesPerSecond;
+        double stepTime;
+        float error;
+};
+
+Result run(std::size_t count, int steps) {
+    robot::ParticleFilter filter(walls, beams, count);
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0, 1);
+
+    // truth drives a 30 inch circle, odometry overestimates distance by 2% and turns 1% too little
+    float x = 30, y = 0, theta = 0;
+    float odomX = x, odomY = y, odomTheta = theta;
+    filter.reset(x, y, theta);
+    const float step = 0.5;
+    const float turn = step / 30;
+
+    std::chrono::duration<double> elapsed(0);
+    float ranges[3];
+    for (int i = 0; i < steps; i++) {
+        x += step * std::sin(theta + turn / 2);
+        y += step * std::cos(theta + turn / 2);
+        theta += turn;
+        const float odomTurn = turn * 0.99f;
+        odomX += step * 1.02f * std::sin(odomTheta + odomTurn / 2);
+        odomY += step * 1.02f * std::cos(odomTheta + odomTurn / 2);
+        odomTheta += odomTurn;
+        for (int b = 0; b < 3; b++) {
+            const float range = cast(x, y, theta, beams[b]);
+            ranges[b] = range < 78.7f ? range + noise(rng) * (0.5f + 0.01f * range) : NAN;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        filter.predict(step * 1.02f, 0, odomTurn);
+        filter.correct(ranges);
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    const robot::ParticleFilter::Estimate estimate = filter.estimate();
+    return {double(filter.size()) * steps / elapsed.count(), elapsed.count() / steps * 1000,
+            std::hypot(estimate.x - x, estimate.y - y)};
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const int steps = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::printf("%10s %16s %12s %10s\n", "particles", "particles/s", "ms/update", "error (in)");
+    for (const std::size_t count : {128, 256, 512, 1024, 2048}) {
+        const Result result = run(count, steps);
+        std::printf("%10zu %16.0f %12.4f %10.2f\n", count, result.particlesPerSecond, result.stepTime, result.error);
+    }
+}
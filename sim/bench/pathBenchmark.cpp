@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "robot/path.hpp"
+
+/**
+ * Benchmark of the closest and lookahead point searches of robot::PathIndex
+ *
+ * Builds winding paths of different lengths at path.jerryio.com's default density of a point every 2 inches, then
+ * follows each one with a robot that stays a little off the path, running one closest point and one lookahead
+ * search per control loop. Compares PathIndex with scanning the whole path every loop, which is what LemLib's follow
+ * does.
+ */
+
+namespace {
+constexpr float SPACING = 2;
+constexpr float LOOKAHEAD = 15;
+
+std::vector<robot::PathPoint> makePath(std::size_t count) {
+    std::vector<robot::PathPoint> points;
+    for (std::size_t i = 0; i < count; i++) {
+        const float t = i * SPACING;
+        points.push_back({t / 4 + 20 * std::sin(t / 30), 20 * std::cos(t / 45), 100, 0, 0});
+    }
+    robot::measurePath(points);
+    return points;
+}
+
+/**
+ * @brief Closest point and lookahead point by scanning every point, like LemLib's follow
+ */
+float scan(const std::vector<robot::PathPoint>& points, float x, float y) {
+    std::size_t closest = 0;
+    float best = INFINITY;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const float squared = (points[i].x - x) * (points[i].x - x) + (points[i].y - y) * (points[i].y - y);
+        if (squared < best) {
+            best = squared;
+            closest = i;
+        }
+    }
+    std::size_t lookahead = closest;
+    while (lookahead + 1 < points.size() && points[lookahead].distance - points[closest].distance < LOOKAHEAD)
+        lookahead++;
+    return points[lookahead].x;
+}
+
+float indexed(robot::PathIndex& index, float x, float y) {
+    const robot::PathIndex::Projection closest = index.closest(x, y);
+    return index.at(closest.distance + LOOKAHEAD).x;
+}
+} // namespace
+
+int main() {
+    std::printf("%8s %12s %14s %10s\n", "points", "scan ns", "PathIndex ns", "speedup");
+    for (const std::size_t count : {100, 1000, 5000, 20000}) {
+        const std::vector<robot::PathPoint> points = makePath(count);
+        const robot::PathView view(points.data(), points.size());
+        // the robot moves about an inch per loop, half an inch off the path
+        std::vector<std::pair<float, float>> positions;
+        for (float distance = 0; distance < points.back().distance; distance += 1) {
+            robot::PathIndex lookup(view);
+            const robot::PathPoint point = lookup.at(distance);
+            positions.push_back({point.x + 0.5f, point.y - 0.5f});
+        }
+
+        volatile float sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& [x, y] : positions) sink = sink + scan(points, x, y);
+        const double scanTime =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+            positions.size();
+
+        robot::PathIndex index(view);
+        start = std::chrono::steady_clock::now();
+        for (const auto& [x, y] : positions) sink = sink + indexed(index, x, y);
+        const double indexTime =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+            positions.size();
+
+        std::printf("%8zu %12.1f %14.1f %9.1fx\n", count, scanTime, indexTime, scanTime / indexTime);
+    }
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "robot/planner.hpp"
+
+/**
+ * Benchmark of robot::PathPlanner
+ *
+ * Plans paths between random poses on a field with a ladder in the middle and a few goals around it, at different
+ * lattice resolutions. Reports the average and the worst planning time, how many targets couldn't be reached, the
+ * closest any planned path gets to an obstacle, and how much longer the paths are than a straight line.
+ */
+
+namespace {
+constexpr int PLANS = 500;
+constexpr float CLEARANCE = 10;
+
+const std::vector<robot::Obstacle> OBSTACLES = {
+    // ladder
+    {-12, -12, 12, 12},
+    // goals
+    {-52, -28, -44, -20},
+    {44, 20, 52, 28},
+    {-28, 44, -20, 52},
+    {20, -52, 28, -44},
+};
+
+std::uint32_t state = 1;
+
+float uniform(float low, float high) {
+    state = state * 1664525 + 1013904223;
+    return low + (high - low) * (state >> 8) / float(1 << 24);
+}
+} // namespace
+
+int main() {
+    std::printf("%10s %10s %10s %8s %14s %10s\n", "resolution", "mean us", "worst us", "failed", "min clearance",
+                "stretch");
+    for (const float resolution : {2.0f, 3.0f, 4.0f}) {
+        robot::PathPlanner planner(OBSTACLES, {.resolution = resolution, .clearance = CLEARANCE});
+        state = 1;
+        double total = 0;
+        double worst = 0;
+        int failed = 0;
+        float minClearance = INFINITY;
+        double stretch = 0;
+        for (int i = 0; i < PLANS; i++) {
+            // random poses clear of the obstacles
+            float pose[6];
+            for (int end = 0; end < 2; end++) {
+                do {
+                    pose[end * 3] = uniform(-60, 60);
+                    pose[end * 3 + 1] = uniform(-60, 60);
+                } while (planner.clearanceAt(pose[end * 3], pose[end * 3 + 1]) < CLEARANCE + resolution);
+                pose[end * 3 + 2] = uniform(-M_PI, M_PI);
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            const robot::PathView path = planner.plan(pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]);
+            const double time =
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            total += time;
+            worst = std::max(worst, time);
+            if (path.size() == 0) {
+                failed++;
+                continue;
+            }
+            for (std::size_t j = 0; j < path.size(); j++)
+                minClearance = std::min(minClearance, planner.clearanceAt(path[j].x, path[j].y));
+            stretch += path[path.size() - 1].distance / std::hypot(pose[3] - pose[0], pose[4] - pose[1]);
+        }
+        std::printf("%10.1f %10.1f %10.1f %8d %14.2f %9.2fx\n", resolution, total / PLANS, worst, failed,
+                    minClearance, stretch / (PLANS - failed));
+    }
+}
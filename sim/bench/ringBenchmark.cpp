@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "robot/ringBuffer.hpp"
+
+/**
+ * Stress check and benchmark of robot::RingBuffer
+ *
+ * Several writer threads each write numbered records of varying length into one ring while a reader takes them out,
+ * like the tasks that log to a TelemetryStream or FlightRecorder. Writers never wait, so records are dropped when the
+ * reader falls behind. The reader checks that every writer's records arrive in order, with the size and contents they
+ * were written with, and that the records read plus the records dropped add up to the records written. Reports how
+ * many records per second go through the ring, and exits with 1 if any check fails.
+ */
+
+namespace {
+constexpr std::size_t HEADER = 4;
+constexpr std::size_t MAX_PAYLOAD = 40;
+
+/** number of bytes of a writer's record */
+std::size_t recordSize(std::uint32_t writer, std::uint32_t index) {
+    return HEADER + (index * 7 + writer) % MAX_PAYLOAD;
+}
+
+/** byte of a writer's record after the header */
+std::uint8_t recordByte(std::uint32_t writer, std::uint32_t index, std::size_t offset) {
+    return std::uint8_t(index * 31 + writer * 17 + offset);
+}
+
+struct Result {
+        bool ok;
+        std::uint64_t read;
+        std::uint64_t dropped;
+        std::uint32_t highWater;
+        double recordsPerSecond;
+};
+
+Result run(std::size_t capacity, std::uint32_t writers, std::uint32_t records) {
+    robot::RingBuffer ring(capacity);
+    std::atomic<std::uint32_t> finished = 0;
+    std::vector<std::uint64_t> writerDropped(writers, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::uint32_t writer = 0; writer < writers; writer++) {
+        threads.emplace_back([&, writer] {
+            for (std::uint32_t index = 0; index < records; index++) {
+                // the header is the writer in the top byte and the index in the rest
+                const std::size_t size = recordSize(writer, index);
+                std::uint8_t* data = ring.reserve(size);
+                if (data == nullptr) {
+                    // give the reader a chance to catch up, so most records still go through
+                    writerDropped[writer]++;
+                    std::this_thread::yield();
+                    continue;
+                }
+                const std::uint32_t header = writer << 24 | index;
+                std::memcpy(data, &header, HEADER);
+                for (std::size_t i = HEADER; i < size; i++) data[i] = recordByte(writer, index, i);
+                ring.commit(data, size);
+            }
+            finished++;
+        });
+    }
+
+    // index of the last record read from each writer, plus one
+    std::vector<std::uint32_t> next(writers, 0);
+    std::vector<std::uint64_t> read(writers, 0);
+    bool ok = true;
+    while (true) {
+        // read everything after the last writer finished, so nothing is left in the ring
+        const bool done = finished == writers;
+        for (robot::RingRecord record = ring.front(); record.data != nullptr; record = ring.front()) {
+            std::uint32_t header = 0;
+            if (record.size >= HEADER) std::memcpy(&header, record.data, HEADER);
+            const std::uint32_t writer = header >> 24;
+            const std::uint32_t index = header & 0xFFFFFF;
+            if (record.size < HEADER || writer >= writers) {
+                std::printf("record of %zu bytes from unknown writer %u\n", record.size, writer);
+                ok = false;
+            } else if (index < next[writer]) {
+                std::printf("writer %u: record %u after record %u\n", writer, index, next[writer] - 1);
+                ok = false;
+            } else if (record.size != recordSize(writer, index)) {
+                std::printf("writer %u: record %u is %zu bytes, not %zu\n", writer, index, record.size,
+                            recordSize(writer, index));
+                ok = false;
+            } else {
+                for (std::size_t i = HEADER; i < record.size; i++) {
+                    if (record.data[i] == recordByte(writer, index, i)) continue;
+                    std::printf("writer %u: record %u differs at byte %zu\n", writer, index, i);
+                    ok = false;
+                    break;
+                }
+                next[writer] = index + 1;
+                read[writer]++;
+            }
+            ring.pop();
+        }
+        if (done) break;
+        std::this_thread::yield();
+    }
+    for (std::thread& thread : threads) thread.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t totalRead = 0;
+    std::uint64_t totalDropped = 0;
+    for (std::uint32_t writer = 0; writer < writers; writer++) {
+        if (read[writer] + writerDropped[writer] != records) {
+            std::printf("writer %u: %llu read and %llu dropped of %u\n", writer, (unsigned long long)read[writer],
+                        (unsigned long long)writerDropped[writer], records);
+            ok = false;
+        }
+        totalRead += read[writer];
+        totalDropped += writerDropped[writer];
+    }
+    if (ring.getDropped() != totalDropped) {
+        std::printf("ring counted %u dropped, writers %llu\n", ring.getDropped(), (unsigned long long)totalDropped);
+        ok = false;
+    }
+    return {ok, totalRead, totalDropped, ring.getHighWater(), totalRead / elapsed.count()};
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    // the index has 24 bits in the record's header
+    const std::uint32_t records = std::min(argc > 1 ? std::atoi(argv[1]) : 200000, 0xFFFFFF);
+    bool ok = true;
+    std::printf("%10s %8s %12s %12s %10s %14s\n", "capacity", "writers", "read", "dropped", "high", "records/s");
+    for (const std::size_t capacity : {256, 4096, 65536}) {
+        for (const std::uint32_t writers : {1, 2, 4, 8}) {
+            const Result result = run(capacity, writers, records);
+            std::printf("%10zu %8u %12llu %12llu %10u %14.0f%s\n", capacity, writers, (unsigned long long)result.read,
+                        (unsigned long long)result.dropped, result.highWater, result.recordsPerSecond,
+                        result.ok ? "" : "  FAILED");
+            ok = ok && result.ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
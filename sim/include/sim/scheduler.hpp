@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace sim {
+/**
+ * @brief Thrown inside a task when the run it belongs to ends
+ *
+ * Tasks are unwound with this exception so infinite task loops can be stopped. Catching it will stall the
+ * simulation, so catch blocks for `...` in code under simulation should rethrow.
+ */
+struct TaskShutdown {};
+
+/**
+ * @brief Run a function as a PROS task on the virtual clock
+ *
+ * Every PROS task runs on its own host thread, but only one of them is ever allowed to run at a time. When the
+ * running task blocks in delay(), delay_until() or on a mutex, the scheduler advances the world to the next wake
+ * time and hands control to the task waking up first. Tasks waking up at the same time run in the order they went
+ * to sleep. This makes runs deterministic and lets them go as fast as the host can step the physics.
+ *
+ * @param entry the function to run. Usually autonomous() or opcontrol()
+ * @param duration the longest time the run can take, in milliseconds
+ * @return the virtual time the run ended at, in milliseconds
+ */
+std::uint32_t run(std::function<void()> entry, std::uint32_t duration);
+} // namespace sim
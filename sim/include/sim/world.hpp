@@ -0,0 +1,290 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Side of the drivetrain a drive motor is mounted on
+ */
+enum class Side { LEFT, RIGHT };
+
+/**
+ * @brief Pose of the simulated robot
+ *
+ * Uses the same convention as LemLib: inches, theta in degrees, 0 degrees facing +y and clockwise positive
+ */
+struct Pose {
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+};
+
+/**
+ * @brief A drive motor. The sign of the port is the direction the motor is mounted in, so a MotorGroup configured
+ * with the same signed port drives the robot forwards with a positive command
+ */
+struct DriveMotor {
+        std::int8_t port;
+        Side side;
+};
+
+/**
+ * @brief A rotation sensor with an unpowered tracking wheel. The sign of the port is the direction the sensor is
+ * mounted in, just like DriveMotor
+ */
+struct TrackingWheel {
+        std::int8_t port;
+        /** wheel diameter, in inches */
+        double diameter;
+        /** vertical wheels: offset to the right of the tracking center. Horizontal wheels: offset forwards */
+        double offset;
+        /** whether the wheel measures forwards (true) or sideways (false) motion */
+        bool vertical;
+};
+
+/**
+ * @brief Physical description of the simulated robot
+ *
+ * The drivetrain is modeled as two first order systems, one per side. A side accelerates towards the velocity its
+ * applied voltage would hold at steady state, with a time constant that depends on whether it is driven, braking or
+ * coasting. Each device latches a new sample every data period with its own phase, like the real smart ports.
+ */
+struct RobotConfig {
+        std::vector<DriveMotor> driveMotors;
+        std::vector<TrackingWheel> trackingWheels;
+        std::vector<std::uint8_t> imus;
+
+        /** distance between the left and right wheels, in inches */
+        double trackWidth = 12.5;
+        /** drive wheel diameter, in inches */
+        double wheelDiameter = 3.25;
+        /** drive wheel rpm at 12V */
+        double rpm = 450;
+        /** cartridge rpm of the drive motors */
+        double motorRpm = 600;
+
+        /** time constant of a driven side, in seconds */
+        double driveTimeConstant = 0.12;
+        /** time constant of a side in brake or hold mode with no command, in seconds */
+        double brakeTimeConstant = 0.04;
+        /** time constant of a coasting side, in seconds */
+        double coastTimeConstant = 0.5;
+        /** time constant of a motor that is not part of the drivetrain, in seconds */
+        double freeTimeConstant = 0.05;
+
+        /** standard deviation of the constant IMU gyro bias, in degrees per second */
+        double imuBias = 0.005;
+        /** standard deviation of the IMU heading noise, in degrees */
+        double imuNoise = 0.01;
+        /** scale error of the IMU heading, as a fraction */
+        double imuScale = 0.002;
+        /** standard deviation of the per-side wheel slip, as a fraction of wheel travel */
+        double wheelSlip = 0.01;
+        /** time the IMU takes to calibrate, in milliseconds */
+        std::uint32_t imuCalibrationTime = 2000;
+
+        /** smart port data period, in milliseconds */
+        std::uint32_t dataRate = 10;
+
+        /** battery voltage at the start of the run, in millivolts */
+        double batteryStart = 12800;
+        /** battery voltage after 60 seconds of driving, in millivolts */
+        double batteryEnd = 12000;
+
+        /** seed for every source of noise in the run */
+        std::uint32_t seed = 0;
+};
+
+/**
+ * @brief State of a smart motor
+ */
+struct MotorState {
+        enum class Mode { VOLTAGE, VELOCITY, ABSOLUTE, BRAKE };
+
+        Mode mode = Mode::VOLTAGE;
+        /** voltage command, in millivolts. Only used in VOLTAGE mode */
+        double voltage = 0;
+        /** velocity target in rpm, or profiled velocity limit in ABSOLUTE mode */
+        double targetVelocity = 0;
+        /** position target, in degrees. Only used in ABSOLUTE mode */
+        double targetPosition = 0;
+
+        std::int32_t brakeMode = 0;
+        std::int32_t gearing = 1;
+        std::int32_t units = 0;
+        std::int32_t currentLimit = 2500;
+        std::int32_t voltageLimit = 0;
+
+        /** direction the motor is mounted in */
+        int mount = 1;
+        /** whether this motor drives one side of the drivetrain */
+        bool drive = false;
+        Side side = Side::LEFT;
+
+        /** shaft position, in degrees, as seen by the mounting direction */
+        double position = 0;
+        /** shaft velocity, in rpm */
+        double velocity = 0;
+        /** voltage actually applied last step, in millivolts */
+        double applied = 0;
+        /** offset subtracted from the position, in degrees */
+        double zero = 0;
+
+        /** last latched sample */
+        double samplePosition = 0;
+        double sampleVelocity = 0;
+        std::uint32_t sampleTime = 0;
+        std::uint32_t phase = 0;
+};
+
+/**
+ * @brief State of a rotation sensor
+ */
+struct RotationState {
+        int mount = 1;
+        /** raw position, in centidegrees */
+        double position = 0;
+        /** raw velocity, in centidegrees per second */
+        double velocity = 0;
+        double zero = 0;
+        std::uint32_t dataRate = 10;
+
+        double samplePosition = 0;
+        double sampleVelocity = 0;
+        std::uint32_t sampleTime = 0;
+        std::uint32_t phase = 0;
+};
+
+/**
+ * @brief State of an inertial sensor
+ */
+struct ImuState {
+        /** constant gyro bias, in degrees per second */
+        double bias = 0;
+        /** heading scale error */
+        double scale = 0;
+        /** integrated rotation, in degrees */
+        double rotation = 0;
+        /** yaw rate, in degrees per second */
+        double rate = 0;
+        /** offset applied by tare_rotation/set_rotation, in degrees */
+        double rotationOffset = 0;
+        /** offset applied by tare_heading/set_heading, in degrees */
+        double headingOffset = 0;
+        /** time calibration finishes, in milliseconds. 0 when not calibrating */
+        std::uint32_t calibrationEnd = 0;
+        bool calibrated = false;
+        std::uint32_t dataRate = 10;
+
+        double sampleRotation = 0;
+        double sampleRate = 0;
+        std::uint32_t sampleTime = 0;
+        std::uint32_t phase = 0;
+};
+
+/**
+ * @brief State of a controller
+ */
+struct ControllerState {
+        std::array<std::int32_t, 4> analog {};
+        std::array<bool, 12> digital {};
+        std::array<bool, 12> reported {};
+};
+
+/**
+ * @brief The simulated field and robot
+ *
+ * There is a single world per process, returned by sim::world(). It is reset between runs with reset(), which makes
+ * runs with the same config and seed bit-for-bit reproducible.
+ */
+class World {
+    public:
+        /**
+         * @brief Reset the world to its initial state
+         *
+         * @param config the robot to simulate
+         */
+        void reset(const RobotConfig& config);
+        /**
+         * @brief Advance the physics by one millisecond
+         */
+        void step();
+        /**
+         * @return current time, in milliseconds
+         */
+        std::uint32_t time() const;
+        /**
+         * @return ground truth pose of the robot
+         */
+        Pose getPose() const;
+        /**
+         * @brief Teleport the robot
+         *
+         * @param pose the new ground truth pose
+         */
+        void setPose(Pose pose);
+        /**
+         * @return ground truth left and right wheel velocities, in inches per second
+         */
+        std::array<double, 2> getWheelVelocities() const;
+        /**
+         * @return the config of the current run
+         */
+        const RobotConfig& getConfig() const;
+        /**
+         * @return the current battery voltage, in millivolts
+         */
+        double getBatteryVoltage() const;
+        /**
+         * @brief Get the motor on a port, creating a free spinning motor if nothing is registered there
+         *
+         * @param port the port, 1-21
+         */
+        MotorState& motor(std::uint8_t port);
+        /**
+         * @return whether a motor has been registered or used on a port
+         */
+        bool isMotor(std::uint8_t port) const;
+        /**
+         * @return the rotation sensor on a port, or nullptr
+         */
+        RotationState* rotation(std::uint8_t port);
+        /**
+         * @return the inertial sensor on a port, or nullptr
+         */
+        ImuState* imu(std::uint8_t port);
+        /**
+         * @return the master or partner controller
+         */
+        ControllerState& controller(int id);
+        /**
+         * @return the deterministic random number generator of this run
+         */
+        std::mt19937& rng();
+    private:
+        void stepMotor(MotorState& motor, double dt);
+
+        RobotConfig config;
+        std::mt19937 generator;
+
+        std::uint32_t now = 0;
+        Pose pose;
+        std::array<double, 2> sideVelocity {};
+        std::array<double, 2> sideSlip {};
+
+        std::map<std::uint8_t, MotorState> motors;
+        std::map<std::uint8_t, RotationState> rotations;
+        std::map<std::uint8_t, ImuState> imus;
+        std::array<ControllerState, 2> controllers {};
+        std::map<std::uint8_t, TrackingWheel> trackingWheels;
+};
+
+/**
+ * @return the simulated world
+ */
+World& world();
+} // namespace sim
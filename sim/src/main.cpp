@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "pros/imu.hpp"
+#include "pros/misc.hpp"
+#include "pros/motor_group.hpp"
+#include "pros/rotation.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// Same ports as src/main.cpp
+pros::MotorGroup leftMotors({-8, 9, -10}, pros::MotorGearset::blue);
+pros::MotorGroup rightMotors({18, -19, 20}, pros::MotorGearset::blue);
+pros::Imu imu(17);
+pros::Rotation horizontalEncoder(15);
+pros::Rotation verticalEncoder(-16);
+pros::Controller controller(pros::E_CONTROLLER_MASTER);
+
+/**
+ * @brief The physical robot the ports above are plugged into
+ */
+sim::RobotConfig robot(std::uint32_t seed) {
+    sim::RobotConfig config;
+    config.driveMotors = {{-8, sim::Side::LEFT},  {9, sim::Side::LEFT},   {-10, sim::Side::LEFT},
+                          {18, sim::Side::RIGHT}, {-19, sim::Side::RIGHT}, {20, sim::Side::RIGHT}};
+    config.trackingWheels = {{15, 2.75, 1.8, false}, {-16, 2.75, 0.3, true}};
+    config.imus = {17};
+    config.trackWidth = 12.5;
+    config.wheelDiameter = 3.25;
+    config.rpm = 450;
+    config.seed = seed;
+    return config;
+}
+
+/**
+ * @brief Drive straight with a P loop on the drive encoders, holding the current heading with the IMU
+ */
+void drive(double inches, double heading) {
+    const double degreesPerInch = 360 / (M_PI * 3.25) * 600 / 450;
+    const double start = (leftMotors.get_position() + rightMotors.get_position()) / 2;
+    const std::uint32_t timeout = pros::millis() + 3000;
+    while (pros::millis() < timeout) {
+        const double traveled = ((leftMotors.get_position() + rightMotors.get_position()) / 2 - start) / degreesPerInch;
+        const double error = inches - traveled;
+        if (std::abs(error) < 0.5 && std::abs(leftMotors.get_actual_velocity()) < 5) break;
+        const double lateral = std::clamp(error * 10, -127.0, 127.0);
+        const double angular = std::remainder(heading - imu.get_rotation(), 360) * 3;
+        leftMotors.move(lateral + angular);
+        rightMotors.move(lateral - angular);
+        pros::delay(10);
+    }
+    leftMotors.brake();
+    rightMotors.brake();
+}
+
+/**
+ * @brief Turn in place to a heading with a P loop on the IMU
+ */
+void turn(double heading) {
+    const std::uint32_t timeout = pros::millis() + 2000;
+    while (pros::millis() < timeout) {
+        const double error = std::remainder(heading - imu.get_rotation(), 360);
+        if (std::abs(error) < 1 && std::abs(imu.get_gyro_rate().z) < 5) break;
+        const double angular = std::clamp(error * 2.5, -100.0, 100.0);
+        leftMotors.move(angular);
+        rightMotors.move(-angular);
+        pros::delay(10);
+    }
+    leftMotors.brake();
+    rightMotors.brake();
+}
+
+/**
+ * @brief Example routine: drive a 24 inch square
+ */
+void autonomous() {
+    imu.reset(true);
+    for (int i = 1; i <= 4; ++i) {
+        drive(24, (i - 1) * 90);
+        turn(i * 90);
+    }
+}
+
+int main(int argc, char** argv) {
+    const int runs = argc > 1 ? std::atoi(argv[1]) : 100;
+    const std::uint32_t firstSeed = argc > 2 ? std::atoi(argv[2]) : 1;
+
+    double sumError = 0, maxError = 0;
+    std::uint64_t simulated = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        sim::world().reset(robot(firstSeed + i));
+        simulated += sim::run(autonomous, 15000);
+        const sim::Pose pose = sim::world().getPose();
+        const double error = std::hypot(pose.x, pose.y);
+        sumError += error;
+        maxError = std::max(maxError, error);
+        std::printf("run %d seed %u: x %.3f y %.3f theta %.3f\n", i, firstSeed + i, pose.x, pose.y, pose.theta);
+    }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%d runs, %.1f s simulated in %.2f s (%.0fx real time)\n", runs, simulated / 1000.0, wall,
+                simulated / 1000.0 / wall);
+    std::printf("final position error: mean %.3f in, max %.3f in\n", sumError / runs, maxError);
+    return 0;
+}
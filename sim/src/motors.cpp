@@ -0,0 +1,419 @@
+#include <cerrno>
+#include <cmath>
+#include "pros/error.h"
+#include "pros/motor_group.hpp"
+#include "sim/world.hpp"
+
+namespace {
+constexpr double STALL_CURRENT = 2500; // mA
+constexpr double NOMINAL_VOLTAGE = 12800; // mV
+
+sim::MotorState& state(std::int8_t port) { return sim::world().motor(std::abs(port)); }
+
+int sign(std::int8_t port) { return port < 0 ? -1 : 1; }
+
+double freeRpm(const sim::MotorState& motor) {
+    if (motor.drive) return sim::world().getConfig().motorRpm;
+    return motor.gearing == 0 ? 100 : motor.gearing == 2 ? 600 : 200;
+}
+
+/**
+ * @brief conversion factor from shaft degrees to the encoder units of the motor
+ */
+double unitsPerDegree(const sim::MotorState& motor) {
+    switch (motor.units) {
+        case 1: return 1.0 / 360;
+        case 2: return (motor.gearing == 0 ? 1800 : motor.gearing == 2 ? 300 : 900) / 360.0;
+        default: return 1;
+    }
+}
+
+/**
+ * @brief current draw estimated from the applied voltage and the back EMF, in mA
+ */
+double current(const sim::MotorState& motor) {
+    const double backEmf = motor.velocity / freeRpm(motor) * NOMINAL_VOLTAGE;
+    const double current = (motor.applied - backEmf) / NOMINAL_VOLTAGE * STALL_CURRENT;
+    return std::clamp(current, -double(motor.currentLimit), double(motor.currentLimit));
+}
+
+double stallTorque(const sim::MotorState& motor) { return 2.1 * 100 / freeRpm(motor); }
+} // namespace
+
+namespace pros {
+inline namespace v5 {
+#define CHECK_INDEX(index, error)                                                                                      \
+    if (index >= _ports.size()) {                                                                                      \
+        errno = EOVERFLOW;                                                                                             \
+        return error;                                                                                                  \
+    }
+#define FOR_ALL(getter)                                                                                                \
+    std::vector<decltype(getter(0))> out;                                                                              \
+    for (std::uint8_t i = 0; i < _ports.size(); ++i) out.push_back(getter(i));                                         \
+    return out;
+#define SET_ALL(setter, value)                                                                                         \
+    for (std::uint8_t i = 0; i < _ports.size(); ++i) setter(value, i);                                                 \
+    return 1;
+
+MotorGroup::MotorGroup(const std::initializer_list<std::int8_t> ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : MotorGroup(std::vector<std::int8_t>(ports), gearset, encoder_units) {}
+
+MotorGroup::MotorGroup(const std::vector<std::int8_t>& ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : _ports(ports) {
+    if (gearset != MotorGears::invalid) set_gearing_all(gearset);
+    if (encoder_units != MotorUnits::invalid) set_encoder_units_all(encoder_units);
+}
+
+MotorGroup::MotorGroup(AbstractMotor& motor_group) : _ports(motor_group.get_port_all()) {}
+
+std::int32_t MotorGroup::move(std::int32_t voltage) const {
+    return move_voltage(std::clamp(voltage, -127, 127) * 12000 / 127);
+}
+
+std::int32_t MotorGroup::move_absolute(const double position, const std::int32_t velocity) const {
+    for (std::int8_t port : _ports) {
+        sim::MotorState& motor = state(port);
+        motor.mode = sim::MotorState::Mode::ABSOLUTE;
+        motor.targetPosition = position / unitsPerDegree(motor) * sign(port);
+        motor.targetVelocity = std::abs(velocity);
+    }
+    return 1;
+}
+
+std::int32_t MotorGroup::move_relative(const double position, const std::int32_t velocity) const {
+    for (std::uint8_t i = 0; i < _ports.size(); ++i) {
+        sim::MotorState& motor = state(_ports[i]);
+        motor.mode = sim::MotorState::Mode::ABSOLUTE;
+        motor.targetPosition = (motor.position - motor.zero) + position / unitsPerDegree(motor) * sign(_ports[i]);
+        motor.targetVelocity = std::abs(velocity);
+    }
+    return 1;
+}
+
+std::int32_t MotorGroup::move_velocity(const std::int32_t velocity) const {
+    for (std::int8_t port : _ports) {
+        sim::MotorState& motor = state(port);
+        motor.mode = sim::MotorState::Mode::VELOCITY;
+        motor.targetVelocity = velocity * sign(port);
+    }
+    return 1;
+}
+
+std::int32_t MotorGroup::move_voltage(const std::int32_t voltage) const {
+    for (std::int8_t port : _ports) {
+        sim::MotorState& motor = state(port);
+        motor.mode = sim::MotorState::Mode::VOLTAGE;
+        motor.voltage = std::clamp(voltage, -12000, 12000) * sign(port);
+    }
+    return 1;
+}
+
+std::int32_t MotorGroup::brake(void) const {
+    for (std::int8_t port : _ports) state(port).mode = sim::MotorState::Mode::BRAKE;
+    return 1;
+}
+
+std::int32_t MotorGroup::modify_profiled_velocity(const std::int32_t velocity) const {
+    for (std::int8_t port : _ports) state(port).targetVelocity = std::abs(velocity);
+    return 1;
+}
+
+double MotorGroup::get_target_position(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_F);
+    const sim::MotorState& motor = state(_ports[index]);
+    return motor.targetPosition * sign(_ports[index]) * unitsPerDegree(motor);
+}
+
+std::vector<double> MotorGroup::get_target_position_all(void) const { FOR_ALL(get_target_position); }
+
+std::int32_t MotorGroup::get_target_velocity(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return std::lround(state(_ports[index]).targetVelocity * sign(_ports[index]));
+}
+
+std::vector<std::int32_t> MotorGroup::get_target_velocity_all(void) const { FOR_ALL(get_target_velocity); }
+
+double MotorGroup::get_actual_velocity(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_F);
+    return state(_ports[index]).sampleVelocity * sign(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_actual_velocity_all(void) const { FOR_ALL(get_actual_velocity); }
+
+std::int32_t MotorGroup::get_current_draw(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return std::lround(current(state(_ports[index])) * sign(_ports[index]));
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_draw_all(void) const { FOR_ALL(get_current_draw); }
+
+std::int32_t MotorGroup::get_direction(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return get_actual_velocity(index) < 0 ? -1 : 1;
+}
+
+std::vector<std::int32_t> MotorGroup::get_direction_all(void) const { FOR_ALL(get_direction); }
+
+double MotorGroup::get_efficiency(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_F);
+    const sim::MotorState& motor = state(_ports[index]);
+    if (motor.applied == 0) return 0;
+    return std::clamp(100 * motor.velocity / freeRpm(motor) * NOMINAL_VOLTAGE / motor.applied, 0.0, 100.0);
+}
+
+std::vector<double> MotorGroup::get_efficiency_all(void) const { FOR_ALL(get_efficiency); }
+
+std::uint32_t MotorGroup::get_faults(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return 0;
+}
+
+std::vector<std::uint32_t> MotorGroup::get_faults_all(void) const { FOR_ALL(get_faults); }
+
+std::uint32_t MotorGroup::get_flags(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return 0;
+}
+
+std::vector<std::uint32_t> MotorGroup::get_flags_all(void) const { FOR_ALL(get_flags); }
+
+double MotorGroup::get_position(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_F);
+    const sim::MotorState& motor = state(_ports[index]);
+    return (motor.samplePosition - motor.zero) * sign(_ports[index]) * unitsPerDegree(motor);
+}
+
+std::vector<double> MotorGroup::get_position_all(void) const { FOR_ALL(get_position); }
+
+double MotorGroup::get_power(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_F);
+    const sim::MotorState& motor = state(_ports[index]);
+    return std::abs(motor.applied * current(motor)) / 1e6;
+}
+
+std::vector<double> MotorGroup::get_power_all(void) const { FOR_ALL(get_power); }
+
+std::int32_t MotorGroup::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    const sim::MotorState& motor = state(_ports[index]);
+    if (timestamp != nullptr) *timestamp = motor.sampleTime;
+    const double counts = motor.gearing == 0 ? 1800 : motor.gearing == 2 ? 300 : 900;
+    return std::lround(motor.samplePosition * sign(_ports[index]) * counts / 360);
+}
+
+std::vector<std::int32_t> MotorGroup::get_raw_position_all(std::uint32_t* const timestamp) const {
+    std::vector<std::int32_t> out;
+    for (std::uint8_t i = 0; i < _ports.size(); ++i) out.push_back(get_raw_position(timestamp, i));
+    return out;
+}
+
+double MotorGroup::get_temperature(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_F);
+    return 25;
+}
+
+std::vector<double> MotorGroup::get_temperature_all(void) const { FOR_ALL(get_temperature); }
+
+double MotorGroup::get_torque(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_F);
+    const sim::MotorState& motor = state(_ports[index]);
+    return current(motor) / STALL_CURRENT * stallTorque(motor) * sign(_ports[index]);
+}
+
+std::vector<double> MotorGroup::get_torque_all(void) const { FOR_ALL(get_torque); }
+
+std::int32_t MotorGroup::get_voltage(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return std::lround(state(_ports[index]).applied * sign(_ports[index]));
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_all(void) const { FOR_ALL(get_voltage); }
+
+std::int32_t MotorGroup::is_over_current(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    const sim::MotorState& motor = state(_ports[index]);
+    return std::abs(current(motor)) >= motor.currentLimit;
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_current_all(void) const { FOR_ALL(is_over_current); }
+
+std::int32_t MotorGroup::is_over_temp(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return 0;
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_temp_all(void) const { FOR_ALL(is_over_temp); }
+
+MotorBrake MotorGroup::get_brake_mode(const std::uint8_t index) const {
+    CHECK_INDEX(index, MotorBrake::invalid);
+    return static_cast<MotorBrake>(state(_ports[index]).brakeMode);
+}
+
+std::vector<MotorBrake> MotorGroup::get_brake_mode_all(void) const { FOR_ALL(get_brake_mode); }
+
+std::int32_t MotorGroup::get_current_limit(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return state(_ports[index]).currentLimit;
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_limit_all(void) const { FOR_ALL(get_current_limit); }
+
+MotorUnits MotorGroup::get_encoder_units(const std::uint8_t index) const {
+    CHECK_INDEX(index, MotorUnits::invalid);
+    return static_cast<MotorUnits>(state(_ports[index]).units);
+}
+
+std::vector<MotorUnits> MotorGroup::get_encoder_units_all(void) const { FOR_ALL(get_encoder_units); }
+
+MotorGears MotorGroup::get_gearing(const std::uint8_t index) const {
+    CHECK_INDEX(index, MotorGears::invalid);
+    return static_cast<MotorGears>(state(_ports[index]).gearing);
+}
+
+std::vector<MotorGears> MotorGroup::get_gearing_all(void) const { FOR_ALL(get_gearing); }
+
+std::vector<std::int8_t> MotorGroup::get_port_all(void) const { return _ports; }
+
+std::int32_t MotorGroup::get_voltage_limit(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return state(_ports[index]).voltageLimit;
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_limit_all(void) const { FOR_ALL(get_voltage_limit); }
+
+std::int32_t MotorGroup::is_reversed(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    return _ports[index] < 0;
+}
+
+std::vector<std::int32_t> MotorGroup::is_reversed_all(void) const { FOR_ALL(is_reversed); }
+
+std::int32_t MotorGroup::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    state(_ports[index]).brakeMode = static_cast<std::int32_t>(mode);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_brake_mode(const pros::motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return set_brake_mode(static_cast<MotorBrake>(mode), index);
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const MotorBrake mode) const { SET_ALL(set_brake_mode, mode); }
+
+std::int32_t MotorGroup::set_brake_mode_all(const pros::motor_brake_mode_e_t mode) const {
+    return set_brake_mode_all(static_cast<MotorBrake>(mode));
+}
+
+std::int32_t MotorGroup::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    state(_ports[index]).currentLimit = limit;
+    return 1;
+}
+
+std::int32_t MotorGroup::set_current_limit_all(const std::int32_t limit) const { SET_ALL(set_current_limit, limit); }
+
+std::int32_t MotorGroup::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    state(_ports[index]).units = static_cast<std::int32_t>(units);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_encoder_units(const pros::motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return set_encoder_units(static_cast<MotorUnits>(units), index);
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const MotorUnits units) const { SET_ALL(set_encoder_units, units); }
+
+std::int32_t MotorGroup::set_encoder_units_all(const pros::motor_encoder_units_e_t units) const {
+    return set_encoder_units_all(static_cast<MotorUnits>(units));
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<pros::motor_gearset_e_t> gearsets) const {
+    for (std::uint8_t i = 0; i < gearsets.size() && i < _ports.size(); ++i) set_gearing(gearsets[i], i);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing(const pros::motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return set_gearing(static_cast<MotorGears>(gearset), index);
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<MotorGears> gearsets) const {
+    for (std::uint8_t i = 0; i < gearsets.size() && i < _ports.size(); ++i) set_gearing(gearsets[i], i);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    state(_ports[index]).gearing = static_cast<std::int32_t>(gearset);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing_all(const MotorGears gearset) const { SET_ALL(set_gearing, gearset); }
+
+std::int32_t MotorGroup::set_gearing_all(const pros::motor_gearset_e_t gearset) const {
+    return set_gearing_all(static_cast<MotorGears>(gearset));
+}
+
+std::int32_t MotorGroup::set_reversed(const bool reverse, const std::uint8_t index) {
+    CHECK_INDEX(index, PROS_ERR);
+    _ports[index] = reverse ? -std::abs(_ports[index]) : std::abs(_ports[index]);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_reversed_all(const bool reverse) { SET_ALL(set_reversed, reverse); }
+
+std::int32_t MotorGroup::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    state(_ports[index]).voltageLimit = limit;
+    return 1;
+}
+
+std::int32_t MotorGroup::set_voltage_limit_all(const std::int32_t limit) const { SET_ALL(set_voltage_limit, limit); }
+
+std::int32_t MotorGroup::set_zero_position(const double position, const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    sim::MotorState& motor = state(_ports[index]);
+    motor.zero = position / unitsPerDegree(motor) * sign(_ports[index]);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_zero_position_all(const double position) const { SET_ALL(set_zero_position, position); }
+
+std::int32_t MotorGroup::tare_position(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR);
+    sim::MotorState& motor = state(_ports[index]);
+    motor.zero = motor.samplePosition;
+    return 1;
+}
+
+std::int32_t MotorGroup::tare_position_all(void) const {
+    for (std::uint8_t i = 0; i < _ports.size(); ++i) tare_position(i);
+    return 1;
+}
+
+std::int8_t MotorGroup::size(void) const { return _ports.size(); }
+
+std::int8_t MotorGroup::get_port(const std::uint8_t index) const {
+    CHECK_INDEX(index, PROS_ERR_BYTE);
+    return _ports[index];
+}
+
+void MotorGroup::operator+=(AbstractMotor& other) { append(other); }
+
+void MotorGroup::append(AbstractMotor& other) {
+    for (std::int8_t port : other.get_port_all()) _ports.push_back(port);
+}
+
+void MotorGroup::erase_port(std::int8_t port) {
+    _ports.erase(std::remove_if(_ports.begin(), _ports.end(),
+                                [port](std::int8_t other) { return std::abs(other) == std::abs(port); }),
+                 _ports.end());
+}
+
+#undef CHECK_INDEX
+#undef FOR_ALL
+#undef SET_ALL
+} // namespace v5
+} // namespace pros
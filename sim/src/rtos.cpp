@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "pros/rtos.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+namespace sim {
+namespace {
+/**
+ * @brief A PROS task running on a host thread
+ */
+struct Task {
+        std::function<void()> entry;
+        std::string name;
+        std::thread thread;
+        std::condition_variable wake;
+        /** virtual time the task wants to run again, in milliseconds */
+        std::uint32_t wakeTime = 0;
+        /** order the task went to sleep in, used to break ties between equal wake times */
+        std::uint64_t sequence = 0;
+        std::uint32_t notifyValue = 0;
+        bool started = false;
+        bool finished = false;
+        bool suspended = false;
+        bool unwinding = false;
+};
+
+/**
+ * @brief State of a PROS mutex
+ */
+struct Mutex {
+        Task* owner = nullptr;
+        bool taken = false;
+};
+
+std::mutex lock;
+std::condition_variable host;
+std::list<Task> tasks;
+Task* current = nullptr;
+std::uint64_t sequence = 0;
+bool stopping = false;
+
+/**
+ * @brief Give control back to the scheduler until the given virtual time
+ *
+ * Must be called from a task. Throws TaskShutdown if the run ended while the task was sleeping.
+ */
+void sleepUntil(std::uint32_t time) {
+    Task* self = current;
+    if (self == nullptr) {
+        // called from outside a run, so there is nothing to hand control to
+        while (world().time() < time) world().step();
+        return;
+    }
+    std::unique_lock<std::mutex> guard(lock);
+    if (self->unwinding) return;
+    self->wakeTime = std::max(time, world().time());
+    self->sequence = ++sequence;
+    current = nullptr;
+    host.notify_one();
+    self->wake.wait(guard, [self] { return current == self; });
+    if (stopping && !self->unwinding) {
+        self->unwinding = true;
+        throw TaskShutdown();
+    }
+}
+
+void taskMain(Task* task) {
+    try {
+        task->entry();
+    } catch (const TaskShutdown&) {}
+    std::lock_guard<std::mutex> guard(lock);
+    task->finished = true;
+    current = nullptr;
+    host.notify_one();
+}
+
+/**
+ * @brief Hand control to a task and wait until it blocks or finishes
+ */
+void resume(Task* task) {
+    std::unique_lock<std::mutex> guard(lock);
+    current = task;
+    if (!task->started) {
+        task->started = true;
+        task->thread = std::thread(taskMain, task);
+    } else {
+        task->wake.notify_one();
+    }
+    host.wait(guard, [] { return current == nullptr; });
+}
+
+Task* spawn(std::function<void()> entry, const char* name) {
+    Task& task = tasks.emplace_back();
+    task.entry = std::move(entry);
+    task.name = name == nullptr ? "" : name;
+    task.wakeTime = world().time();
+    task.sequence = ++sequence;
+    return &task;
+}
+
+Task* handle(pros::task_t task) { return task == nullptr ? current : static_cast<Task*>(task); }
+} // namespace
+
+std::uint32_t run(std::function<void()> entry, std::uint32_t duration) {
+    stopping = false;
+    Task* main = spawn(std::move(entry), "User Task");
+    const std::uint32_t end = world().time() + duration;
+
+    while (!main->finished) {
+        Task* next = nullptr;
+        for (Task& task : tasks) {
+            if (task.finished || task.suspended) continue;
+            if (next == nullptr || task.wakeTime < next->wakeTime ||
+                (task.wakeTime == next->wakeTime && task.sequence < next->sequence))
+                next = &task;
+        }
+        if (next == nullptr || next->wakeTime > end) break;
+        while (world().time() < next->wakeTime) world().step();
+        resume(next);
+    }
+    const std::uint32_t ended = std::min(world().time(), end);
+
+    // unwind every task that is still alive, in the order they were created
+    stopping = true;
+    for (Task& task : tasks) {
+        if (!task.started) continue;
+        while (!task.finished) resume(&task);
+    }
+    for (Task& task : tasks) {
+        if (task.thread.joinable()) task.thread.join();
+    }
+    tasks.clear();
+    stopping = false;
+    return ended;
+}
+} // namespace sim
+
+namespace pros {
+namespace c {
+uint32_t millis(void) { return sim::world().time(); }
+
+uint64_t micros(void) { return uint64_t(sim::world().time()) * 1000; }
+
+void task_delay(const uint32_t milliseconds) { sim::sleepUntil(sim::world().time() + milliseconds); }
+
+void delay(const uint32_t milliseconds) { task_delay(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+    *prev_time += delta;
+    sim::sleepUntil(*prev_time);
+}
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                   const char* const name) {
+    return sim::spawn([function, parameters] { function(parameters); }, name);
+}
+
+void task_delete(task_t task) {
+    sim::Task* target = sim::handle(task);
+    if (target == nullptr) return;
+    if (target == sim::current) throw sim::TaskShutdown();
+    target->suspended = true;
+}
+
+uint32_t task_get_priority(task_t task) { return TASK_PRIORITY_DEFAULT; }
+
+void task_set_priority(task_t task, uint32_t prio) {}
+
+task_state_e_t task_get_state(task_t task) {
+    sim::Task* target = sim::handle(task);
+    if (target == nullptr) return E_TASK_STATE_INVALID;
+    if (target->finished) return E_TASK_STATE_DELETED;
+    if (target->suspended) return E_TASK_STATE_SUSPENDED;
+    if (target == sim::current) return E_TASK_STATE_RUNNING;
+    return target->wakeTime > sim::world().time() ? E_TASK_STATE_BLOCKED : E_TASK_STATE_READY;
+}
+
+void task_suspend(task_t task) {
+    sim::Task* target = sim::handle(task);
+    if (target == nullptr) return;
+    target->suspended = true;
+    if (target == sim::current) sim::sleepUntil(sim::world().time());
+}
+
+void task_resume(task_t task) {
+    sim::Task* target = sim::handle(task);
+    if (target == nullptr) return;
+    target->suspended = false;
+    target->wakeTime = std::max(target->wakeTime, sim::world().time());
+}
+
+uint32_t task_get_count(void) {
+    return std::count_if(sim::tasks.begin(), sim::tasks.end(), [](const sim::Task& task) { return !task.finished; });
+}
+
+char* task_get_name(task_t task) {
+    sim::Task* target = sim::handle(task);
+    return target == nullptr ? nullptr : target->name.data();
+}
+
+task_t task_get_by_name(const char* name) {
+    for (sim::Task& task : sim::tasks) {
+        if (task.name == name) return &task;
+    }
+    return nullptr;
+}
+
+task_t task_get_current() { return sim::current; }
+
+uint32_t task_notify(task_t task) { return task_notify_ext(task, 0, E_NOTIFY_ACTION_INCR, nullptr); }
+
+void task_join(task_t task) {
+    sim::Task* target = sim::handle(task);
+    while (target != nullptr && !target->finished) sim::sleepUntil(sim::world().time() + 1);
+}
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+    sim::Task* target = sim::handle(task);
+    if (target == nullptr) return 0;
+    if (prev_value != nullptr) *prev_value = target->notifyValue;
+    switch (action) {
+        case E_NOTIFY_ACTION_BITS: target->notifyValue |= value; break;
+        case E_NOTIFY_ACTION_INCR: ++target->notifyValue; break;
+        case E_NOTIFY_ACTION_OWRITE: target->notifyValue = value; break;
+        case E_NOTIFY_ACTION_NO_OWRITE:
+            if (target->notifyValue != 0) return 0;
+            target->notifyValue = value;
+            break;
+        case E_NOTIFY_ACTION_NONE: break;
+    }
+    return 1;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+    sim::Task* self = sim::current;
+    if (self == nullptr) return 0;
+    const uint32_t start = sim::world().time();
+    while (self->notifyValue == 0 && (timeout == TIMEOUT_MAX || sim::world().time() - start < timeout)) {
+        sim::sleepUntil(sim::world().time() + 1);
+    }
+    const uint32_t value = self->notifyValue;
+    if (clear_on_exit) self->notifyValue = 0;
+    else if (value > 0) --self->notifyValue;
+    return value;
+}
+
+bool task_notify_clear(task_t task) {
+    sim::Task* target = sim::handle(task);
+    if (target == nullptr) return false;
+    const bool pending = target->notifyValue != 0;
+    target->notifyValue = 0;
+    return pending;
+}
+
+mutex_t mutex_create(void) { return new sim::Mutex(); }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+    sim::Mutex* state = static_cast<sim::Mutex*>(mutex);
+    const uint32_t start = sim::world().time();
+    // blocked tasks poll every millisecond, which keeps the scheduler simple and deterministic
+    while (state->taken) {
+        if (sim::current == nullptr) return false;
+        if (timeout != TIMEOUT_MAX && sim::world().time() - start >= timeout) return false;
+        sim::sleepUntil(sim::world().time() + 1);
+    }
+    state->taken = true;
+    state->owner = sim::current;
+    return true;
+}
+
+bool mutex_give(mutex_t mutex) {
+    sim::Mutex* state = static_cast<sim::Mutex*>(mutex);
+    if (!state->taken) return false;
+    state->taken = false;
+    state->owner = nullptr;
+    return true;
+}
+
+void mutex_delete(mutex_t mutex) { delete static_cast<sim::Mutex*>(mutex); }
+} // namespace c
+
+inline namespace rtos {
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+    : task(c::task_create(function, parameters, prio, stack_depth, name)) {}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task) : task(task) {}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+Task& Task::operator=(task_t in) {
+    task = in;
+    return *this;
+}
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char* Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::task_delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point(duration(c::millis())); }
+
+Mutex::Mutex() : mutex(c::mutex_create(), c::mutex_delete) {}
+
+bool Mutex::take() { return c::mutex_take(mutex.get(), TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) { return c::mutex_take(mutex.get(), timeout); }
+
+bool Mutex::give() { return c::mutex_give(mutex.get()); }
+
+void Mutex::lock() {
+    while (!take(TIMEOUT_MAX));
+}
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+} // namespace rtos
+} // namespace pros
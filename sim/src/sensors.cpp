@@ -0,0 +1,281 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <map>
+#include "pros/error.h"
+#include "pros/imu.hpp"
+#include "pros/misc.hpp"
+#include "pros/rotation.hpp"
+#include "sim/world.hpp"
+
+namespace {
+/**
+ * @brief rotation sensors reversed in software. This is configuration, not physics, so it survives world resets
+ */
+std::map<std::uint8_t, bool>& reversedRotations() {
+    static std::map<std::uint8_t, bool> reversed;
+    return reversed;
+}
+
+int direction(std::uint8_t port) { return reversedRotations()[port] ? -1 : 1; }
+
+double wrap(double angle, double low) { return angle - 360 * std::floor((angle - low) / 360); }
+} // namespace
+
+namespace pros {
+inline namespace v5 {
+Device::Device(const std::uint8_t port) : _port(port), _deviceType(get_plugged_type(port)) {}
+
+std::uint8_t Device::get_port(void) const { return _port; }
+
+bool Device::is_installed() { return get_plugged_type() == _deviceType; }
+
+DeviceType Device::get_plugged_type() const { return get_plugged_type(_port); }
+
+DeviceType Device::get_plugged_type(std::uint8_t port) {
+    if (sim::world().imu(port) != nullptr) return DeviceType::imu;
+    if (sim::world().rotation(port) != nullptr) return DeviceType::rotation;
+    if (sim::world().isMotor(port)) return DeviceType::motor;
+    return DeviceType::none;
+}
+
+// inertial sensor
+namespace {
+sim::ImuState* imuState(std::uint8_t port) {
+    sim::ImuState* state = sim::world().imu(port);
+    if (state == nullptr) errno = ENODEV;
+    else if (state->calibrationEnd != 0) errno = EAGAIN;
+    else return state;
+    return nullptr;
+}
+} // namespace
+
+std::int32_t Imu::reset(bool blocking) const {
+    sim::ImuState* state = sim::world().imu(_port);
+    if (state == nullptr) {
+        errno = ENODEV;
+        return PROS_ERR;
+    }
+    state->calibrationEnd = sim::world().time() + sim::world().getConfig().imuCalibrationTime;
+    if (blocking) {
+        while (state->calibrationEnd != 0) pros::c::delay(10);
+    }
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const {
+    sim::ImuState* state = imuState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->dataRate = std::max<std::uint32_t>(5, rate - rate % 5);
+    return 1;
+}
+
+double Imu::get_rotation() const {
+    sim::ImuState* state = imuState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return state->sampleRotation - state->rotationOffset;
+}
+
+double Imu::get_heading() const {
+    sim::ImuState* state = imuState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return wrap(state->sampleRotation - state->headingOffset, 0);
+}
+
+pros::quaternion_s_t Imu::get_quaternion() const {
+    const double yaw = get_yaw() * M_PI / 180;
+    if (std::isinf(yaw)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    return {0, 0, -std::sin(yaw / 2), std::cos(yaw / 2)};
+}
+
+pros::euler_s_t Imu::get_euler() const { return {get_pitch(), get_roll(), get_yaw()}; }
+
+double Imu::get_pitch() const { return imuState(_port) == nullptr ? PROS_ERR_F : 0; }
+
+double Imu::get_roll() const { return imuState(_port) == nullptr ? PROS_ERR_F : 0; }
+
+double Imu::get_yaw() const {
+    const double heading = get_heading();
+    return std::isinf(heading) ? heading : wrap(heading, -180);
+}
+
+pros::imu_gyro_s_t Imu::get_gyro_rate() const {
+    sim::ImuState* state = imuState(_port);
+    if (state == nullptr) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    return {0, 0, state->sampleRate};
+}
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return imuState(_port) == nullptr ? PROS_ERR : 1; }
+
+std::int32_t Imu::tare_yaw() const { return set_yaw(0); }
+
+std::int32_t Imu::tare_roll() const { return imuState(_port) == nullptr ? PROS_ERR : 1; }
+
+std::int32_t Imu::tare() const {
+    if (tare_rotation() == PROS_ERR) return PROS_ERR;
+    return tare_heading();
+}
+
+std::int32_t Imu::tare_euler() const { return tare_yaw(); }
+
+std::int32_t Imu::set_heading(const double target) const {
+    sim::ImuState* state = imuState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->headingOffset = state->sampleRotation - target;
+    return 1;
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+    sim::ImuState* state = imuState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->rotationOffset = state->sampleRotation - target;
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const { return set_heading(wrap(target, 0)); }
+
+std::int32_t Imu::set_pitch(const double target) const { return imuState(_port) == nullptr ? PROS_ERR : 1; }
+
+std::int32_t Imu::set_roll(const double target) const { return imuState(_port) == nullptr ? PROS_ERR : 1; }
+
+std::int32_t Imu::set_euler(const pros::euler_s_t target) const { return set_yaw(target.yaw); }
+
+pros::imu_accel_s_t Imu::get_accel() const {
+    if (imuState(_port) == nullptr) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    return {0, 0, 1};
+}
+
+pros::ImuStatus Imu::get_status() const {
+    sim::ImuState* state = sim::world().imu(_port);
+    if (state == nullptr) {
+        errno = ENODEV;
+        return ImuStatus::error;
+    }
+    return state->calibrationEnd != 0 ? ImuStatus::calibrating : ImuStatus::ready;
+}
+
+bool Imu::is_calibrating() const { return get_status() == ImuStatus::calibrating; }
+
+imu_orientation_e_t Imu::get_physical_orientation() const {
+    return imuState(_port) == nullptr ? E_IMU_ORIENTATION_ERROR : E_IMU_Z_UP;
+}
+
+// rotation sensor
+namespace {
+sim::RotationState* rotationState(std::uint8_t port) {
+    sim::RotationState* state = sim::world().rotation(port);
+    if (state == nullptr) errno = ENODEV;
+    return state;
+}
+} // namespace
+
+Rotation::Rotation(const std::int8_t port) : Device(std::abs(port), DeviceType::rotation) {
+    reversedRotations()[_port] = port < 0;
+}
+
+std::int32_t Rotation::reset() { return reset_position(); }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t rate) const {
+    sim::RotationState* state = rotationState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->dataRate = std::max<std::uint32_t>(5, rate - rate % 5);
+    return 1;
+}
+
+std::int32_t Rotation::set_position(std::uint32_t position) const {
+    sim::RotationState* state = rotationState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->zero = state->samplePosition - double(std::int32_t(position)) * direction(_port);
+    return 1;
+}
+
+std::int32_t Rotation::reset_position(void) const { return set_position(0); }
+
+std::int32_t Rotation::get_position() const {
+    sim::RotationState* state = rotationState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return std::lround((state->samplePosition - state->zero) * direction(_port));
+}
+
+std::int32_t Rotation::get_velocity() const {
+    sim::RotationState* state = rotationState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return std::lround(state->sampleVelocity * direction(_port));
+}
+
+std::int32_t Rotation::get_angle() const {
+    sim::RotationState* state = rotationState(_port);
+    if (state == nullptr) return PROS_ERR;
+    const std::int32_t position = std::lround(state->samplePosition * direction(_port));
+    return ((position % 36000) + 36000) % 36000;
+}
+
+std::int32_t Rotation::set_reversed(bool value) const {
+    if (rotationState(_port) == nullptr) return PROS_ERR;
+    reversedRotations()[_port] = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() const { return set_reversed(!reversedRotations()[_port]); }
+
+std::int32_t Rotation::get_reversed() const {
+    if (rotationState(_port) == nullptr) return PROS_ERR;
+    return reversedRotations()[_port];
+}
+
+// controller
+Controller::Controller(controller_id_e_t id) : _id(id) {}
+
+std::int32_t Controller::is_connected(void) { return 1; }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) {
+    return sim::world().controller(_id).analog.at(channel);
+}
+
+std::int32_t Controller::get_battery_capacity(void) { return 100; }
+
+std::int32_t Controller::get_battery_level(void) { return 100; }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) {
+    return sim::world().controller(_id).digital.at(button - E_CONTROLLER_DIGITAL_L1);
+}
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    sim::ControllerState& state = sim::world().controller(_id);
+    const std::size_t index = button - E_CONTROLLER_DIGITAL_L1;
+    const bool pressed = state.digital.at(index) && !state.reported.at(index);
+    state.reported[index] = state.digital[index];
+    return pressed;
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) { return 1; }
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) { return 1; }
+
+std::int32_t Controller::clear_line(std::uint8_t line) { return 1; }
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return 1; }
+
+std::int32_t Controller::clear(void) { return 1; }
+} // namespace v5
+
+namespace battery {
+double get_capacity(void) { return 100; }
+
+int32_t get_current(void) { return 0; }
+
+double get_temperature(void) { return 25; }
+
+int32_t get_voltage(void) { return std::lround(sim::world().getBatteryVoltage()); }
+} // namespace battery
+
+namespace c {
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) { return 1; }
+
+int32_t battery_get_voltage(void) { return pros::battery::get_voltage(); }
+} // namespace c
+} // namespace pros
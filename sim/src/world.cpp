@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+#include "sim/world.hpp"
+
+namespace sim {
+namespace {
+constexpr double DT = 0.001;
+constexpr double NOMINAL_VOLTAGE = 12800;
+
+/**
+ * @brief free speed of a cartridge, in rpm
+ */
+double cartridgeRpm(std::int32_t gearing) {
+    switch (gearing) {
+        case 0: return 100;
+        case 2: return 600;
+        default: return 200;
+    }
+}
+
+/**
+ * @brief whether a device should latch a new sample this millisecond
+ */
+bool latch(std::uint32_t now, std::uint32_t phase, std::uint32_t period) {
+    return period == 0 || (now + phase) % period == 0;
+}
+} // namespace
+
+void World::reset(const RobotConfig& config) {
+    this->config = config;
+    generator.seed(config.seed);
+    now = 0;
+    pose = Pose();
+    sideVelocity = {0, 0};
+    motors.clear();
+    rotations.clear();
+    imus.clear();
+    controllers = {};
+    trackingWheels.clear();
+
+    std::normal_distribution<double> slip(0, config.wheelSlip);
+    sideSlip = {slip(generator), slip(generator)};
+
+    std::uniform_int_distribution<std::uint32_t> phase(0, std::max<std::uint32_t>(config.dataRate, 1) - 1);
+    for (const DriveMotor& driveMotor : config.driveMotors) {
+        MotorState& state = motors[std::abs(driveMotor.port)];
+        state.mount = driveMotor.port < 0 ? -1 : 1;
+        state.drive = true;
+        state.side = driveMotor.side;
+        state.gearing = config.motorRpm >= 600 ? 2 : config.motorRpm <= 100 ? 0 : 1;
+        state.phase = phase(generator);
+    }
+    for (const TrackingWheel& wheel : config.trackingWheels) {
+        RotationState& state = rotations[std::abs(wheel.port)];
+        state.mount = wheel.port < 0 ? -1 : 1;
+        state.dataRate = config.dataRate;
+        state.phase = phase(generator);
+        trackingWheels[std::abs(wheel.port)] = wheel;
+    }
+    std::normal_distribution<double> bias(0, config.imuBias);
+    std::normal_distribution<double> scale(0, config.imuScale);
+    for (std::uint8_t port : config.imus) {
+        ImuState& state = imus[port];
+        state.bias = bias(generator);
+        state.scale = scale(generator);
+        state.dataRate = config.dataRate;
+        state.phase = phase(generator);
+    }
+}
+
+void World::stepMotor(MotorState& motor, double dt) {
+    const double freeRpm = motor.drive ? config.motorRpm : cartridgeRpm(motor.gearing);
+    const double limit = motor.voltageLimit > 0 ? std::min<double>(motor.voltageLimit, 12000) : 12000;
+
+    // the motor firmware closes velocity and position loops on its own
+    double command = 0;
+    bool braking = false;
+    switch (motor.mode) {
+        case MotorState::Mode::VOLTAGE: command = motor.voltage; break;
+        case MotorState::Mode::BRAKE: braking = true; break;
+        case MotorState::Mode::ABSOLUTE: {
+            const double error = motor.targetPosition - (motor.position - motor.zero);
+            const double target = std::clamp(error * 2, -std::abs(motor.targetVelocity), std::abs(motor.targetVelocity));
+            command = target / freeRpm * 12000 + (target - motor.velocity) * 40;
+            break;
+        }
+        case MotorState::Mode::VELOCITY:
+            command = motor.targetVelocity / freeRpm * 12000 + (motor.targetVelocity - motor.velocity) * 40;
+            braking = motor.targetVelocity == 0 && std::abs(motor.velocity) < 1;
+            break;
+    }
+    if (motor.mode == MotorState::Mode::VOLTAGE && command == 0 && motor.brakeMode != 0) braking = true;
+    command = std::clamp(command, -limit, limit);
+    motor.applied = command / 12000 * getBatteryVoltage();
+
+    // drive motors are slaved to the drivetrain model
+    if (motor.drive) return;
+    const double tau = braking ? config.brakeTimeConstant
+                               : (command == 0 ? config.coastTimeConstant : config.freeTimeConstant);
+    const double target = braking ? 0 : motor.applied / NOMINAL_VOLTAGE * freeRpm;
+    motor.velocity += (target - motor.velocity) * std::min(dt / tau, 1.0);
+    motor.position += motor.velocity * 6 * dt;
+}
+
+void World::step() {
+    ++now;
+
+    // drivetrain
+    const double freeSpeed = config.rpm / 60 * M_PI * config.wheelDiameter;
+    std::array<double, 2> voltage {};
+    std::array<int, 2> count {};
+    std::array<bool, 2> braking {true, true};
+    for (auto& [port, motor] : motors) {
+        stepMotor(motor, DT);
+        if (!motor.drive) continue;
+        const int side = motor.side == Side::LEFT ? 0 : 1;
+        voltage[side] += motor.applied * motor.mount;
+        ++count[side];
+        const bool stopped = motor.mode == MotorState::Mode::BRAKE ||
+                             (motor.mode == MotorState::Mode::VOLTAGE && motor.voltage == 0 && motor.brakeMode != 0);
+        braking[side] = braking[side] && stopped;
+    }
+    for (int side = 0; side < 2; ++side) {
+        if (count[side] == 0) continue;
+        const double applied = voltage[side] / count[side];
+        double tau = config.driveTimeConstant;
+        if (braking[side]) tau = config.brakeTimeConstant;
+        else if (applied == 0) tau = config.coastTimeConstant;
+        const double target = braking[side] ? 0 : applied / NOMINAL_VOLTAGE * freeSpeed;
+        sideVelocity[side] += (target - sideVelocity[side]) * std::min(DT / tau, 1.0);
+    }
+
+    // the ground moves slightly less than the drive wheels
+    const double left = sideVelocity[0] * (1 - sideSlip[0]);
+    const double right = sideVelocity[1] * (1 - sideSlip[1]);
+    const double linear = (left + right) / 2;
+    const double angular = (left - right) / config.trackWidth; // radians per second, clockwise
+
+    // exact arc integration
+    const double theta = pose.theta * M_PI / 180;
+    const double deltaTheta = angular * DT;
+    double forward = linear * DT;
+    if (std::abs(deltaTheta) > 1e-9) forward = 2 * linear / angular * std::sin(deltaTheta / 2);
+    pose.x += forward * std::sin(theta + deltaTheta / 2);
+    pose.y += forward * std::cos(theta + deltaTheta / 2);
+    pose.theta += deltaTheta * 180 / M_PI;
+
+    // drive motor encoders measure the wheels, not the ground
+    const double degreesPerInch = 360 / (M_PI * config.wheelDiameter) * config.motorRpm / config.rpm;
+    for (auto& [port, motor] : motors) {
+        if (!motor.drive) continue;
+        const double velocity = sideVelocity[motor.side == Side::LEFT ? 0 : 1] * degreesPerInch * motor.mount;
+        motor.velocity = velocity / 6;
+        motor.position += velocity * DT;
+    }
+
+    // tracking wheels
+    for (auto& [port, rotation] : rotations) {
+        auto wheel = trackingWheels.find(port);
+        if (wheel == trackingWheels.end()) continue;
+        const double speed = wheel->second.vertical ? linear - angular * wheel->second.offset
+                                                    : angular * wheel->second.offset;
+        rotation.velocity = speed / (M_PI * wheel->second.diameter) * 36000 * rotation.mount;
+        rotation.position += rotation.velocity * DT;
+    }
+
+    // inertial sensors
+    std::normal_distribution<double> noise(0, config.imuNoise);
+    for (auto& [port, imu] : imus) {
+        imu.rate = angular * 180 / M_PI * (1 + imu.scale) + imu.bias;
+        if (imu.calibrationEnd != 0 && now >= imu.calibrationEnd) {
+            imu.calibrationEnd = 0;
+            imu.calibrated = true;
+            imu.rotation = 0;
+            imu.rotationOffset = 0;
+            imu.headingOffset = 0;
+        }
+        imu.rotation += imu.rate * DT;
+        if (latch(now, imu.phase, imu.dataRate)) {
+            imu.sampleRotation = imu.rotation + noise(generator);
+            imu.sampleRate = imu.rate;
+            imu.sampleTime = now;
+        }
+    }
+
+    // latch smart port samples
+    for (auto& [port, motor] : motors) {
+        if (!latch(now, motor.phase, config.dataRate)) continue;
+        motor.samplePosition = motor.position;
+        motor.sampleVelocity = motor.velocity;
+        motor.sampleTime = now;
+    }
+    for (auto& [port, rotation] : rotations) {
+        if (!latch(now, rotation.phase, rotation.dataRate)) continue;
+        rotation.samplePosition = rotation.position;
+        rotation.sampleVelocity = rotation.velocity;
+        rotation.sampleTime = now;
+    }
+}
+
+std::uint32_t World::time() const { return now; }
+
+Pose World::getPose() const { return pose; }
+
+void World::setPose(Pose pose) { this->pose = pose; }
+
+std::array<double, 2> World::getWheelVelocities() const { return sideVelocity; }
+
+const RobotConfig& World::getConfig() const { return config; }
+
+double World::getBatteryVoltage() const {
+    const double t = std::min(now / 60000.0, 1.0);
+    return config.batteryStart + (config.batteryEnd - config.batteryStart) * t;
+}
+
+MotorState& World::motor(std::uint8_t port) { return motors[port]; }
+
+bool World::isMotor(std::uint8_t port) const { return motors.count(port) != 0; }
+
+RotationState* World::rotation(std::uint8_t port) {
+    auto it = rotations.find(port);
+    return it == rotations.end() ? nullptr : &it->second;
+}
+
+ImuState* World::imu(std::uint8_t port) {
+    auto it = imus.find(port);
+    return it == imus.end() ? nullptr : &it->second;
+}
+
+ControllerState& World::controller(int id) { return controllers[id == 0 ? 0 : 1]; }
+
+std::mt19937& World::rng() { return generator; }
+
+World& world() {
+    static World instance;
+    return instance;
+}
+} // namespace sim
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "robot/feedforward.hpp"
+
+/**
+ * Fits feedforward gains to drivetrain characterization runs
+ *
+ * Reads the "time,power,velocity" lines robot::Chassis::characterize prints, from the files given as arguments or
+ * from stdin, and prints the gains to put in robot::ControllerSettings. Any line that isn't 3 numbers, like the
+ * header each run starts with, separates runs, so the logs of several runs can be concatenated. Acceleration is
+ * differentiated from the velocity within each run.
+ *
+ * Usage: characterize [minVelocity] < terminal.txt
+ *        characterize [minVelocity] ramp.csv step.csv
+ */
+
+namespace {
+/** samples on each side of a sample used to differentiate its velocity */
+constexpr std::size_t SPAN = 2;
+
+struct Reading {
+        float time;
+        float power;
+        float velocity;
+};
+
+/**
+ * @brief Differentiate a run and add it to the samples
+ */
+void addRun(const std::vector<Reading>& run, std::vector<robot::FeedforwardSample>& samples) {
+    for (std::size_t i = SPAN; i + SPAN < run.size(); i++) {
+        const float duration = (run[i + SPAN].time - run[i - SPAN].time) / 1000;
+        if (duration <= 0) continue;
+        const float acceleration = (run[i + SPAN].velocity - run[i - SPAN].velocity) / duration;
+        samples.push_back({run[i].power, run[i].velocity, acceleration});
+    }
+}
+
+void read(std::FILE* file, std::vector<robot::FeedforwardSample>& samples, int& runs) {
+    std::vector<Reading> run;
+    char line[256];
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        Reading reading;
+        if (std::sscanf(line, "%f,%f,%f", &reading.time, &reading.power, &reading.velocity) == 3) {
+            run.push_back(reading);
+            continue;
+        }
+        if (!run.empty()) runs++;
+        addRun(run, samples);
+        run.clear();
+    }
+    if (!run.empty()) runs++;
+    addRun(run, samples);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int first = 1;
+    float minVelocity = 1;
+    if (argc > 1) {
+        char* end;
+        const float value = std::strtof(argv[1], &end);
+        if (*end == '\0') {
+            minVelocity = value;
+            first = 2;
+        }
+    }
+
+    std::vector<robot::FeedforwardSample> samples;
+    int runs = 0;
+    if (first >= argc) read(stdin, samples, runs);
+    for (int i = first; i < argc; i++) {
+        std::FILE* file = std::fopen(argv[i], "r");
+        if (file == nullptr) {
+            std::fprintf(stderr, "can't open %s\n", argv[i]);
+            return 1;
+        }
+        read(file, samples, runs);
+        std::fclose(file);
+    }
+
+    const robot::FeedforwardFit fit = robot::fitFeedforward(samples, minVelocity);
+    if (fit.feedforward.kV == 0) {
+        std::fprintf(stderr, "%zu samples from %d runs don't determine the gains, log a ramp and a step\n",
+                     fit.samples, runs);
+        return 1;
+    }
+    std::printf("runs: %d, samples used: %zu\n", runs, fit.samples);
+    std::printf("kS: %.4f\nkV: %.4f\nkA: %.4f\nr^2: %.4f\n", fit.feedforward.kS, fit.feedforward.kV,
+                fit.feedforward.kA, fit.rSquared);
+}
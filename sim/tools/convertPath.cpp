@@ -0,0 +1,49 @@
+#include <cstdio>
+#include <vector>
+#include "robot/path.hpp"
+
+/**
+ * Converts a path from the text format LemLib's follow reads to a binary path
+ *
+ * The binary path is a robot::PathHeader followed by packed robot::PathPoint records, with the curvature and
+ * distance of every point already computed by the same code the robot would run. The build runs this on every path
+ * in static/, see PATH_ASSET. Files that aren't paths convert to a path with no points.
+ *
+ * Usage: convertPath input.txt output.path
+ */
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s input.txt output.path\n", argv[0]);
+        return 1;
+    }
+
+    std::FILE* input = std::fopen(argv[1], "rb");
+    if (input == nullptr) {
+        std::fprintf(stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<std::uint8_t> text;
+    std::uint8_t buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), input)) > 0) text.insert(text.end(), buffer, buffer + read);
+    std::fclose(input);
+
+    const std::vector<robot::PathPoint> points = robot::parsePath(asset {text.data(), text.size()});
+    const robot::PathHeader header = {robot::PATH_MAGIC, static_cast<std::uint32_t>(points.size())};
+
+    // the V5 brain is little endian like every computer this runs on, so the records are written as they are
+    std::FILE* output = std::fopen(argv[2], "wb");
+    if (output == nullptr) {
+        std::fprintf(stderr, "can't open %s\n", argv[2]);
+        return 1;
+    }
+    const bool written = std::fwrite(&header, sizeof(header), 1, output) == 1 &&
+                         std::fwrite(points.data(), sizeof(robot::PathPoint), points.size(), output) == points.size();
+    if (std::fclose(output) != 0 || !written) {
+        std::fprintf(stderr, "can't write %s\n", argv[2]);
+        return 1;
+    }
+    std::printf("%s: %zu points, %.2f inches\n", argv[1], points.size(),
+                points.empty() ? 0.0f : points.back().distance);
+}
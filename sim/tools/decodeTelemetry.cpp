@@ -0,0 +1,80 @@
+#include <cstdio>
+#include "robot/telemetry.hpp"
+
+/**
+ * Converts a capture of robot::TelemetryStream or a robot::FlightRecorder file to CSV
+ *
+ * A capture is every byte the brain sent over the serial link, for example from "cat /dev/ttyACM1 > capture.bin"
+ * while the robot runs. Text printed between the frames is skipped. Flight recorder files come from the SD card,
+ * several files of one recording can be concatenated in order. The CSV has a time column in milliseconds and a
+ * column per channel, and a new header row wherever the channels change. Logged messages and the footers of
+ * recordings go to stderr.
+ *
+ * Usage: decodeTelemetry capture.bin [output.csv]
+ */
+
+namespace {
+/** names of lemlib::Level, in order */
+const char* const LEVELS[] = {"INFO", "DEBUG", "WARN", "ERROR", "FATAL"};
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        std::fprintf(stderr, "usage: %s capture.bin [output.csv]\n", argv[0]);
+        return 1;
+    }
+
+    std::FILE* input = std::fopen(argv[1], "rb");
+    if (input == nullptr) {
+        std::fprintf(stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+    std::FILE* output = argc == 3 ? std::fopen(argv[2], "w") : stdout;
+    if (output == nullptr) {
+        std::fprintf(stderr, "can't open %s\n", argv[2]);
+        std::fclose(input);
+        return 1;
+    }
+
+    robot::TelemetryDecoder decoder;
+    std::size_t samples = 0;
+    std::uint8_t buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), input)) > 0) {
+        decoder.push(buffer, read);
+        for (robot::TelemetryEvent event; (event = decoder.next()) != robot::TelemetryEvent::NONE;) {
+            if (event == robot::TelemetryEvent::SCHEMA) {
+                std::fprintf(output, "time");
+                for (const robot::TelemetryChannel& channel : decoder.getChannels())
+                    std::fprintf(output, ",%s", channel.name.c_str());
+                std::fprintf(output, "\n");
+                continue;
+            }
+            if (event == robot::TelemetryEvent::TEXT) {
+                const robot::TelemetryText& text = decoder.getText();
+                std::fprintf(stderr, "[%lu] %s: %s\n", static_cast<unsigned long>(text.time),
+                             text.level < 5 ? LEVELS[text.level] : "?", text.text.c_str());
+                continue;
+            }
+            if (event == robot::TelemetryEvent::FOOTER) {
+                const robot::TelemetryFooter& footer = decoder.getFooter();
+                std::fprintf(stderr, "end of recording: %lu samples, %lu frames dropped\n",
+                             static_cast<unsigned long>(footer.samples), static_cast<unsigned long>(footer.dropped));
+                continue;
+            }
+            std::fprintf(output, "%lu", static_cast<unsigned long>(decoder.getTime()));
+            for (float value : decoder.getValues()) std::fprintf(output, ",%g", value);
+            std::fprintf(output, "\n");
+            samples++;
+        }
+    }
+    std::fclose(input);
+
+    if (output != stdout && std::fclose(output) != 0) {
+        std::fprintf(stderr, "can't write %s\n", argv[2]);
+        return 1;
+    }
+    std::fprintf(stderr, "%s: %zu samples, %lu corrupt frames, %lu frames skipped after a lost frame\n", argv[1],
+                 samples, static_cast<unsigned long>(decoder.getCorrupt()),
+                 static_cast<unsigned long>(decoder.getSkipped()));
+}
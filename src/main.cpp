@@ -51,7 +51,7 @@ lemlib::ControllerSettings angularController(2, // kP
 );
 
 // Finalize chassis                                             
-lemlib::Chassis chassis(drivetrain, lateralController, angularController, odom);
+robot::Chassis chassis(drivetrain, lateralController, angularController, odom);
 
 // Get pneumatics
 pros::adi::Pneumatics leftWing(0, false);
@@ -92,9 +92,9 @@ void initialize() {
     // Initialize robot
     leftMotors.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
     rightMotors.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    chassis.calibrate();
+    robot::CalibrationHandle calibration = chassis.calibrateAsync();
 
-    // Initialize brain screen
+    // Initialize brain screen while the sensors calibrate
     lv_init();
     screen = lv_scr_act();
 
@@ -151,6 +151,8 @@ void initialize() {
             pros::delay(20);
         }
     });
+
+    calibration.wait();
 }
 
 void disabled() {}
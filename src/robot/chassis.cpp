@@ -0,0 +1,694 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "pros/misc.h"
+#include "pros/misc.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "robot/chassis.hpp"
+#include "robot/odom.hpp"
+
+namespace robot {
+namespace {
+/** how long the IMU usually takes to calibrate, in milliseconds */
+constexpr float IMU_CALIBRATION_TIME = 2000;
+/** distance from the target where the robot stops turning towards it, in inches. Same as moveToPoint */
+constexpr float CLOSE_DISTANCE = 7.5;
+/** distance from the end of a path where pure pursuit stops, about half the spacing of path points, in inches */
+constexpr float END_TOLERANCE = 1;
+/** longest gap between two chained motions for the velocity to carry over, in milliseconds */
+constexpr std::uint32_t CARRY_TIMEOUT = 100;
+/** voltage move() and move_voltage() treat as full power, in millivolts */
+constexpr float MAX_VOLTAGE = 12000;
+/** longest gap between driver control updates before the velocity controller starts over, in milliseconds */
+constexpr std::uint32_t VELOCITY_DRIVE_TIMEOUT = 100;
+/** longest gap between drivetrain outputs before traction control starts over, in milliseconds */
+constexpr std::uint32_t TRACTION_TIMEOUT = 100;
+
+/**
+ * @brief Get the fastest the drivetrain's wheels can move, in inches per second
+ */
+float topSpeed(const lemlib::Drivetrain& drivetrain) {
+    return drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+}
+} // namespace
+
+CalibrationHandle::CalibrationHandle()
+    : state(std::make_shared<State>()) {}
+
+CalibrationStatus CalibrationHandle::getStatus() const {
+    state->mutex.take();
+    const CalibrationStatus out = state->status;
+    state->mutex.give();
+    return out;
+}
+
+bool CalibrationHandle::isDone() const { return getStatus().done; }
+
+bool CalibrationHandle::wait(std::uint32_t timeout) const {
+    const std::uint32_t start = pros::millis();
+    while (!isDone()) {
+        if (pros::millis() - start >= timeout) return false;
+        pros::delay(10);
+    }
+    return true;
+}
+
+void CalibrationHandle::update(const CalibrationStatus& status) const {
+    state->mutex.take();
+    state->status = status;
+    state->mutex.give();
+}
+
+Chassis::Chassis(lemlib::Drivetrain drivetrain, ControllerSettings lateralSettings, ControllerSettings angularSettings,
+                 lemlib::OdomSensors sensors, lemlib::DriveCurve* throttleCurve, lemlib::DriveCurve* steerCurve)
+    : lemlib::Chassis(drivetrain, lateralSettings, angularSettings, sensors, throttleCurve, steerCurve),
+      lateralFeedforward(lateralSettings.feedforward),
+      angularFeedforward(angularSettings.feedforward) {}
+
+Feedforward Chassis::getLateralFeedforward() const {
+    if (lateralFeedforward.kV != 0) return lateralFeedforward;
+    // full power at top speed, with no friction or inertia
+    return {0, 127 / topSpeed(drivetrain), 0};
+}
+
+Feedforward Chassis::getAngularFeedforward() const {
+    if (angularFeedforward.kV != 0) return angularFeedforward;
+    // full power turns the wheels at top speed around the middle of the drivetrain
+    const float topRate = lemlib::radToDeg(topSpeed(drivetrain) / (drivetrain.trackWidth / 2));
+    return {0, 127 / topRate, 0};
+}
+
+void Chassis::setVoltageCompensation(bool enabled, std::int32_t nominalVoltage) {
+    voltageCompensation = enabled;
+    this->nominalVoltage = nominalVoltage;
+}
+
+void Chassis::setTractionControl(bool enabled, TractionSettings settings) {
+    const auto isTrackingWheel = [](lemlib::TrackingWheel* wheel) { return wheel != nullptr && wheel->getType() == 0; };
+    if (enabled && !isTrackingWheel(sensors.vertical1) && !isTrackingWheel(sensors.vertical2)) {
+        lemlib::infoSink()->warn("Traction control needs a vertical tracking wheel, not enabling it");
+        enabled = false;
+    }
+    tractionControl = enabled;
+    leftTraction = TractionControl(settings);
+    rightTraction = TractionControl(settings);
+    lastTraction = 0;
+}
+
+bool Chassis::isSlipping() const {
+    return tractionControl && (leftTraction.isSlipping() || rightTraction.isSlipping());
+}
+
+void Chassis::drive(float left, float right) {
+    if (tractionControl) {
+        const std::uint32_t now = pros::millis();
+        if (lastTraction == 0 || now - lastTraction > TRACTION_TIMEOUT) {
+            leftTraction.reset();
+            rightTraction.reset();
+            lastTraction = now - 10;
+        }
+        const float time = std::max<std::uint32_t>(now - lastTraction, 1) / 1000.0f;
+        lastTraction = now;
+
+        // velocity of the ground under each side, from the tracking wheels and the IMU
+        const lemlib::Pose pose = getPose(true);
+        const lemlib::Pose speed = getSpeedAt(now, true);
+        const float forward = speed.x * std::sin(pose.theta) + speed.y * std::cos(pose.theta);
+        const float turn = speed.theta * drivetrain.trackWidth / 2;
+        const Feedforward feedforward = getLateralFeedforward();
+        // a side pushing something barely moves, but still takes at least kS to keep pushing
+        const float leftGrip = std::max(std::fabs(feedforward.calculate(forward + turn)), feedforward.kS);
+        const float rightGrip = std::max(std::fabs(feedforward.calculate(forward - turn)), feedforward.kS);
+        left = leftTraction.update(left, wheelVelocity(drivetrain.leftMotors), forward + turn, leftGrip, time);
+        right = rightTraction.update(right, wheelVelocity(drivetrain.rightMotors), forward - turn, rightGrip, time);
+    }
+
+    const std::int32_t battery = pros::battery::get_voltage();
+    // without a battery reading, fall back to the uncompensated output
+    if (!voltageCompensation || battery <= 0 || battery == PROS_ERR) {
+        drivetrain.leftMotors->move(left);
+        drivetrain.rightMotors->move(right);
+        return;
+    }
+    // the motors apply their command as a fraction of the battery's voltage
+    const float scale = nominalVoltage / 127.0f * MAX_VOLTAGE / battery;
+    drivetrain.leftMotors->move_voltage(std::clamp(left * scale, -MAX_VOLTAGE, MAX_VOLTAGE));
+    drivetrain.rightMotors->move_voltage(std::clamp(right * scale, -MAX_VOLTAGE, MAX_VOLTAGE));
+}
+
+void Chassis::setVelocityDrive(bool enabled, VelocityDriveSettings settings) {
+    velocityDrive = enabled;
+    velocitySettings = settings;
+    leftVelocityPID.emplace(settings.kP, settings.kI, settings.kD);
+    rightVelocityPID.emplace(settings.kP, settings.kI, settings.kD);
+    lastDriverOutput = 0;
+}
+
+float Chassis::wheelVelocity(pros::MotorGroup* motors) const {
+    // the motors measure the rpm of their cartridge's output
+    float cartridge = 200;
+    switch (motors->get_gearing()) {
+        case pros::MotorGears::red: cartridge = 100; break;
+        case pros::MotorGears::blue: cartridge = 600; break;
+        default: break;
+    }
+    float sum = 0;
+    int count = 0;
+    for (const double velocity : motors->get_actual_velocity_all()) {
+        // disconnected motors read infinity
+        if (!std::isfinite(velocity)) continue;
+        sum += velocity;
+        count++;
+    }
+    if (count == 0) return 0;
+    return sum / count * drivetrain.rpm / cartridge / 60 * M_PI * drivetrain.wheelDiameter;
+}
+
+void Chassis::driverOutput(float left, float right) {
+    if (!velocityDrive) {
+        drive(left, right);
+        return;
+    }
+    const Feedforward feedforward = getLateralFeedforward();
+    const float maxVelocity = (127 - feedforward.kS) / feedforward.kV;
+    const float leftVelocity = wheelVelocity(drivetrain.leftMotors);
+    const float rightVelocity = wheelVelocity(drivetrain.rightMotors);
+
+    // start from the current velocities after a motion or a pause
+    const std::uint32_t now = pros::millis();
+    if (lastDriverOutput == 0 || now - lastDriverOutput > VELOCITY_DRIVE_TIMEOUT) {
+        leftVelocityPID->reset();
+        rightVelocityPID->reset();
+        leftTarget = leftVelocity;
+        rightTarget = rightVelocity;
+        lastDriverOutput = now - 10;
+    }
+    const float time = std::max<std::uint32_t>(now - lastDriverOutput, 1) / 1000.0f;
+    lastDriverOutput = now;
+
+    // move the targets towards the sticks, no faster than the acceleration limit
+    const float maxChange = velocitySettings.maxAcceleration > 0 ? velocitySettings.maxAcceleration * time : INFINITY;
+    const float leftChange = std::clamp(left / 127 * maxVelocity - leftTarget, -maxChange, maxChange);
+    const float rightChange = std::clamp(right / 127 * maxVelocity - rightTarget, -maxChange, maxChange);
+    leftTarget += leftChange;
+    rightTarget += rightChange;
+
+    const float leftPower = feedforward.calculate(leftTarget, leftChange / time) +
+                            leftVelocityPID->update(leftTarget - leftVelocity);
+    const float rightPower = feedforward.calculate(rightTarget, rightChange / time) +
+                             rightVelocityPID->update(rightTarget - rightVelocity);
+    drive(std::clamp(leftPower, -127.0f, 127.0f), std::clamp(rightPower, -127.0f, 127.0f));
+}
+
+void Chassis::tank(int left, int right, bool disableDriveCurve) {
+    if (!voltageCompensation && !velocityDrive && !tractionControl) {
+        lemlib::Chassis::tank(left, right, disableDriveCurve);
+        return;
+    }
+    if (disableDriveCurve) driverOutput(left, right);
+    else driverOutput(throttleCurve->curve(left), throttleCurve->curve(right));
+}
+
+void Chassis::arcade(int throttle, int turn, bool disableDriveCurve, float desaturateBias) {
+    if (!voltageCompensation && !velocityDrive && !tractionControl) {
+        lemlib::Chassis::arcade(throttle, turn, disableDriveCurve, desaturateBias);
+        return;
+    }
+    // same as LemLib's arcade
+    if (!disableDriveCurve) {
+        throttle = throttleCurve->curve(throttle);
+        turn = steerCurve->curve(turn);
+    }
+    if (std::abs(throttle) + std::abs(turn) > 127) {
+        const int oldThrottle = throttle;
+        const int oldTurn = turn;
+        throttle *= (1 - desaturateBias * std::abs(oldTurn / 127.0));
+        turn *= (1 - (1 - desaturateBias) * std::abs(oldThrottle / 127.0));
+    }
+    driverOutput(throttle + turn, throttle - turn);
+}
+
+void Chassis::curvature(int throttle, int turn, bool disableDriveCurve) {
+    if (!voltageCompensation && !velocityDrive && !tractionControl) {
+        lemlib::Chassis::curvature(throttle, turn, disableDriveCurve);
+        return;
+    }
+    // same as LemLib's curvature, which is arcade when not moving forwards
+    if (throttle == 0) return arcade(throttle, turn, disableDriveCurve);
+    if (!disableDriveCurve) {
+        throttle = throttleCurve->curve(throttle);
+        turn = steerCurve->curve(turn);
+    }
+    float leftPower = throttle + (std::abs(throttle) * turn) / 127.0f;
+    float rightPower = throttle - (std::abs(throttle) * turn) / 127.0f;
+    const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / 127;
+    if (ratio > 1) {
+        leftPower /= ratio;
+        rightPower /= ratio;
+    }
+    driverOutput(leftPower, rightPower);
+}
+
+void Chassis::handOff(float velocityX, float velocityY) {
+    carriedX = velocityX;
+    carriedY = velocityY;
+    carriedTime = pros::millis();
+    // the queued motion takes over the motors without stopping them
+    if ((velocityX != 0 || velocityY != 0) && motionQueued) return;
+    drive(0, 0);
+}
+
+void Chassis::dropHandOff() {
+    // the motion that was meant to take over the motors was cancelled, so nothing else will stop them
+    if ((carriedX != 0 || carriedY != 0) && pros::millis() - carriedTime <= CARRY_TIMEOUT) drive(0, 0);
+    carriedX = 0;
+    carriedY = 0;
+}
+
+float Chassis::takeEntryVelocity(float directionX, float directionY) {
+    // only the part of the velocity along the new direction carries over
+    const float out =
+        pros::millis() - carriedTime <= CARRY_TIMEOUT ? std::max(carriedX * directionX + carriedY * directionY, 0.0f)
+                                                      : 0;
+    carriedX = 0;
+    carriedY = 0;
+    return out;
+}
+
+void Chassis::calibrate(bool calibrateIMU, std::uint32_t odomPeriod) {
+    calibrateAsync(calibrateIMU, odomPeriod).wait();
+}
+
+CalibrationHandle Chassis::calibrateAsync(bool calibrateIMU, std::uint32_t odomPeriod) {
+    const CalibrationHandle handle;
+    pros::Task::create(
+        [this, handle, calibrateIMU, odomPeriod] {
+            CalibrationStatus status;
+
+            // start calibrating the IMU first, since it takes the longest
+            const bool useIMU = sensors.imu != nullptr && calibrateIMU;
+            std::uint32_t start = pros::millis();
+            if (useIMU) {
+                sensors.imu->reset();
+                status.imuAttempts = 1;
+                handle.update(status);
+            }
+
+            // fall back to the drive encoders for missing vertical tracking wheels
+            if (sensors.vertical1 == nullptr)
+                sensors.vertical1 = new lemlib::TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                              -(drivetrain.trackWidth / 2), drivetrain.rpm);
+            if (sensors.vertical2 == nullptr)
+                sensors.vertical2 = new lemlib::TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                              drivetrain.trackWidth / 2, drivetrain.rpm);
+            sensors.vertical1->reset();
+            sensors.vertical2->reset();
+            if (sensors.horizontal1 != nullptr) sensors.horizontal1->reset();
+            if (sensors.horizontal2 != nullptr) sensors.horizontal2->reset();
+
+            // wait for the IMU, retrying up to 5 times
+            while (useIMU) {
+                do {
+                    pros::delay(10);
+                    status.progress = std::min((pros::millis() - start) / IMU_CALIBRATION_TIME, 0.99f);
+                    handle.update(status);
+                } while (sensors.imu->get_status() != pros::ImuStatus::error && sensors.imu->is_calibrating());
+                const double heading = sensors.imu->get_heading();
+                if (!std::isnan(heading) && !std::isinf(heading)) break;
+                pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
+                lemlib::infoSink()->warn("IMU failed to calibrate! Attempt #{}", status.imuAttempts);
+                if (status.imuAttempts == 5) {
+                    sensors.imu = nullptr;
+                    status.imuFailed = true;
+                    lemlib::infoSink()->error("IMU calibration failed, defaulting to tracking wheels / motor encoders");
+                    break;
+                }
+                sensors.imu->reset();
+                start = pros::millis();
+                status.imuAttempts++;
+            }
+
+            initOdom(sensors, drivetrain, odomPeriod);
+            status.progress = 1;
+            status.done = true;
+            handle.update(status);
+            pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, ".");
+        },
+        "Calibration");
+    return handle;
+}
+
+void Chassis::moveToPointProfiled(float x, float y, int timeout, ProfiledMoveParams params, bool async) {
+    requestMotionStart();
+    // were all motions cancelled?
+    if (!motionRunning) {
+        dropHandOff();
+        return;
+    }
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this] { moveToPointProfiled(x, y, timeout, params, false); });
+        endMotion();
+        pros::delay(10);
+        return;
+    }
+
+    lateralPID.reset();
+    angularPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+
+    // plan the straight line to the target
+    const lemlib::Pose start = getPose(true);
+    const float length = std::hypot(x - start.x, y - start.y);
+    const float directionX = length > 0 ? (x - start.x) / length : 0;
+    const float directionY = length > 0 ? (y - start.y) / length : 0;
+    const Feedforward feedforward = getLateralFeedforward();
+    // the fastest the feedforward can drive with some power left for the PID
+    const float maxVelocity = (127 * 0.9f - feedforward.kS) / feedforward.kV;
+    ProfileConstraints constraints = params.constraints;
+    if (constraints.maxVelocity <= 0 || constraints.maxVelocity > maxVelocity) constraints.maxVelocity = maxVelocity;
+    const MotionProfile profile(length, constraints, takeEntryVelocity(directionX, directionY), params.exitVelocity);
+    const float sign = params.forwards ? 1 : -1;
+    const bool chained = params.exitVelocity > 0 || params.earlyExitRange > 0;
+    float exitVelocity = 0;
+
+    distTraveled = 0;
+    lemlib::Pose lastPose = start;
+    bool close = false;
+    const std::uint32_t startTime = pros::millis();
+    while (motionRunning && int(pros::millis() - startTime) < timeout) {
+        const float time = (pros::millis() - startTime) / 1000.0f;
+        const lemlib::Pose pose = getPose(true);
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // progress along the line, compared to where the profile should be
+        const float progress = (pose.x - start.x) * directionX + (pose.y - start.y) * directionY;
+        const ProfileState reference = profile.sample(time);
+        // hand off to the next motion instead of settling
+        if (chained && (progress >= length - params.earlyExitRange || time >= profile.getDuration())) {
+            exitVelocity = reference.velocity;
+            break;
+        }
+        if (time >= profile.getDuration()) {
+            lateralSmallExit.update(length - progress);
+            lateralLargeExit.update(length - progress);
+            if (lateralSmallExit.getExit() || lateralLargeExit.getExit()) break;
+        }
+        float lateralOut = sign * (feedforward.calculate(reference.velocity, reference.acceleration) +
+                                   lateralPID.update(reference.position - progress));
+        lateralOut = std::clamp(lateralOut, -127.0f, 127.0f);
+
+        // keep pointing at the target until close enough that small position errors would swing the heading
+        if (std::hypot(x - pose.x, y - pose.y) < CLOSE_DISTANCE) close = true;
+        float angularOut = 0;
+        if (!close) {
+            const float heading = params.forwards ? pose.theta : pose.theta + M_PI;
+            angularOut = angularPID.update(
+                lemlib::radToDeg(lemlib::angleError(std::atan2(x - pose.x, y - pose.y), heading)));
+        }
+
+        // scale both sides down together so turning isn't lost to saturation
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / 127;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+        drive(leftPower, rightPower);
+        pros::delay(10);
+    }
+
+    handOff(exitVelocity * directionX, exitVelocity * directionY);
+    distTraveled = -1;
+    endMotion();
+}
+
+void Chassis::turnToHeadingProfiled(float theta, int timeout, ProfiledTurnParams params, bool async) {
+    requestMotionStart();
+    // were all motions cancelled?
+    if (!motionRunning) {
+        dropHandOff();
+        return;
+    }
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this] { turnToHeadingProfiled(theta, timeout, params, false); });
+        endMotion();
+        pros::delay(10);
+        return;
+    }
+
+    angularPID.reset();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+    // turning in place can't keep the robot moving
+    takeEntryVelocity(0, 0);
+
+    // plan the turn. LemLib's heading isn't wrapped, so progress is the change in heading
+    const float start = getPose().theta;
+    const float angle = lemlib::angleError(theta, start, false, params.direction);
+    const Feedforward feedforward = getAngularFeedforward();
+    const float maxVelocity = (127 * 0.9f - feedforward.kS) / feedforward.kV;
+    ProfileConstraints constraints = params.constraints;
+    if (constraints.maxVelocity <= 0 || constraints.maxVelocity > maxVelocity) constraints.maxVelocity = maxVelocity;
+    const MotionProfile profile(angle, constraints);
+
+    distTraveled = 0;
+    const std::uint32_t startTime = pros::millis();
+    while (motionRunning && int(pros::millis() - startTime) < timeout) {
+        const float time = (pros::millis() - startTime) / 1000.0f;
+        const float progress = getPose().theta - start;
+        distTraveled = std::fabs(progress);
+
+        const ProfileState reference = profile.sample(time);
+        if (time >= profile.getDuration()) {
+            angularSmallExit.update(angle - progress);
+            angularLargeExit.update(angle - progress);
+            if (angularSmallExit.getExit() || angularLargeExit.getExit()) break;
+        }
+        const float angularOut =
+            std::clamp(feedforward.calculate(reference.velocity, reference.acceleration) +
+                           angularPID.update(reference.position - progress),
+                       -127.0f, 127.0f);
+        drive(angularOut, -angularOut);
+        pros::delay(10);
+    }
+
+    drive(0, 0);
+    distTraveled = -1;
+    endMotion();
+}
+
+void Chassis::followProfiled(const asset& path, int timeout, ProfiledFollowParams params, bool async) {
+    if (async) {
+        requestMotionStart();
+        // were all motions cancelled?
+        if (!motionRunning) {
+            dropHandOff();
+            return;
+        }
+        pros::Task task([&path, timeout, params, this] { followProfiled(path, timeout, params, false); });
+        endMotion();
+        pros::delay(10);
+        return;
+    }
+    // the parsed points have to outlive the motion
+    const std::vector<PathPoint> points = parsePath(path);
+    followProfiled(PathView(points.data(), points.size()), timeout, params, false);
+}
+
+void Chassis::followProfiled(PathView path, int timeout, ProfiledFollowParams params, bool async) {
+    requestMotionStart();
+    // were all motions cancelled?
+    if (!motionRunning) {
+        dropHandOff();
+        return;
+    }
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this] { followProfiled(path, timeout, params, false); });
+        endMotion();
+        pros::delay(10);
+        return;
+    }
+
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+
+    if (path.size() < 2) {
+        lemlib::infoSink()->warn("Path has fewer than 2 points, not following it");
+        endMotion();
+        return;
+    }
+    const Feedforward feedforward = getLateralFeedforward();
+    const float maxVelocity = (127 * 0.9f - feedforward.kS) / feedforward.kV;
+    const float velocity =
+        params.maxVelocity <= 0 || params.maxVelocity > maxVelocity ? maxVelocity : params.maxVelocity;
+    // the robot starts along the first segment of the path
+    const float startLength = std::hypot(path[1].x - path[0].x, path[1].y - path[0].y);
+    const float entryVelocity =
+        startLength > 0
+            ? takeEntryVelocity((path[1].x - path[0].x) / startLength, (path[1].y - path[0].y) / startLength)
+            : takeEntryVelocity(0, 0);
+    PathProfile profile(path, {velocity, params.maxAcceleration, params.maxLateralAcceleration, drivetrain.trackWidth},
+                        entryVelocity, params.exitVelocity);
+    const PathPoint& end = path[path.size() - 1];
+    const float sign = params.forwards ? 1 : -1;
+    const bool chained = params.exitVelocity > 0 || params.earlyExitRange > 0;
+    float exitX = 0;
+    float exitY = 0;
+
+    distTraveled = 0;
+    lemlib::Pose lastPose = getPose(true);
+    const std::uint32_t startTime = pros::millis();
+    while (motionRunning && int(pros::millis() - startTime) < timeout) {
+        const float time = (pros::millis() - startTime) / 1000.0f;
+        const lemlib::Pose pose = getPose(true);
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        const PathProfile::State target = profile.sample(time);
+        // hand off to the next motion instead of settling
+        if (chained && (profile.isDone() || profile.getDistance() >= end.distance - params.earlyExitRange)) {
+            exitX = target.velocity * std::sin(target.theta);
+            exitY = target.velocity * std::cos(target.theta);
+            break;
+        }
+        if (profile.isDone()) {
+            const float remaining = std::hypot(end.x - pose.x, end.y - pose.y);
+            lateralSmallExit.update(remaining);
+            lateralLargeExit.update(remaining);
+            if (lateralSmallExit.getExit() || lateralLargeExit.getExit()) break;
+        }
+
+        // driving backwards is driving forwards with the back of the robot
+        const ChassisSpeeds speeds =
+            ramsete(target, pose.x, pose.y, params.forwards ? pose.theta : pose.theta + M_PI, params.b, params.zeta);
+        const float lateral = sign * speeds.velocity;
+        const float turn = speeds.angularVelocity * drivetrain.trackWidth / 2;
+        const float acceleration = sign * target.acceleration;
+
+        float leftPower = feedforward.calculate(lateral + turn, acceleration);
+        float rightPower = feedforward.calculate(lateral - turn, acceleration);
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / 127;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+        drive(leftPower, rightPower);
+        pros::delay(10);
+    }
+
+    handOff(exitX, exitY);
+    distTraveled = -1;
+    endMotion();
+}
+
+void Chassis::follow(PathView path, float lookahead, int timeout, bool forwards, bool async) {
+    requestMotionStart();
+    // were all motions cancelled?
+    if (!motionRunning) {
+        dropHandOff();
+        return;
+    }
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this] { follow(path, lookahead, timeout, forwards, false); });
+        endMotion();
+        pros::delay(10);
+        return;
+    }
+
+    if (path.size() < 2) {
+        lemlib::infoSink()->warn("Path has fewer than 2 points, not following it");
+        endMotion();
+        return;
+    }
+    PathIndex index(path);
+    const float length = path[path.size() - 1].distance;
+    float previousVelocity = 0;
+
+    distTraveled = 0;
+    lemlib::Pose lastPose = getPose(true);
+    const std::uint32_t startTime = pros::millis();
+    while (motionRunning && int(pros::millis() - startTime) < timeout) {
+        const lemlib::Pose pose = getPose(true);
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // done once the end of the path is the closest point, like LemLib's follow
+        const PathIndex::Projection closest = index.closest(pose.x, pose.y);
+        if (length - closest.distance < END_TOLERANCE) break;
+        const PathPoint target = index.at(closest.distance + lookahead);
+
+        // curvature of the arc from the robot to the lookahead point, positive to the right
+        const float heading = forwards ? pose.theta : pose.theta + M_PI;
+        const float deltaX = target.x - pose.x;
+        const float deltaY = target.y - pose.y;
+        const float right = deltaX * std::cos(heading) - deltaY * std::sin(heading);
+        const float squared = deltaX * deltaX + deltaY * deltaY;
+        const float curvature = squared > 0 ? 2 * right / squared : 0;
+
+        // the path's speed at the closest point, slewed like LemLib's follow
+        const float velocity = lemlib::slew(index.at(closest.distance).speed, previousVelocity, lateralSettings.slew);
+        previousVelocity = velocity;
+        float leftPower = velocity * (1 + curvature * drivetrain.trackWidth / 2);
+        float rightPower = velocity * (1 - curvature * drivetrain.trackWidth / 2);
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / 127;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+        // driving backwards mirrors the sides
+        if (forwards) {
+            drive(leftPower, rightPower);
+        } else {
+            drive(-rightPower, -leftPower);
+        }
+        pros::delay(10);
+    }
+
+    drive(0, 0);
+    distTraveled = -1;
+    endMotion();
+}
+
+void Chassis::characterize(CharacterizationParams params) {
+    requestMotionStart();
+    // were all motions cancelled?
+    if (!motionRunning) {
+        dropHandOff();
+        return;
+    }
+
+    const float sign = params.reversed ? -1 : 1;
+    for (const bool step : {false, true}) {
+        // each run starts with a header, which the characterize tool uses to split runs
+        std::printf("time,power,velocity\n");
+        const int duration = step ? params.stepTime : params.rampTime;
+        const std::uint32_t start = pros::millis();
+        std::uint32_t next = start;
+        while (motionRunning && int(pros::millis() - start) < duration) {
+            const std::uint32_t now = pros::millis();
+            const float power =
+                sign * std::min(step ? params.stepPower : params.rampRate * (now - start) / 1000, 127.0f);
+            drive(power, params.angular ? -power : power);
+
+            const lemlib::Pose pose = getPose(true);
+            const lemlib::Pose speed = getSpeedAt(now, true);
+            const float velocity = params.angular ? lemlib::radToDeg(speed.theta)
+                                                  : speed.x * std::sin(pose.theta) + speed.y * std::cos(pose.theta);
+            std::printf("%lu,%.2f,%.3f\n", static_cast<unsigned long>(now), power, velocity);
+            pros::Task::delay_until(&next, 10);
+        }
+        // let the robot come to a stop between runs
+        drive(0, 0);
+        pros::delay(1000);
+    }
+    endMotion();
+}
+} // namespace robot
@@ -0,0 +1,61 @@
+#include <cmath>
+#include <utility>
+#include "robot/feedforward.hpp"
+
+namespace robot {
+float Feedforward::calculate(float velocity, float acceleration) const {
+    // a robot at rest needs to break friction in the direction it's about to move
+    const float direction = velocity != 0 ? velocity : acceleration;
+    const float sign = direction > 0 ? 1 : direction < 0 ? -1 : 0;
+    return kS * sign + kV * velocity + kA * acceleration;
+}
+
+FeedforwardFit fitFeedforward(const std::vector<FeedforwardSample>& samples, float minVelocity) {
+    // normal equations of power = kS * sign + kV * velocity + kA * acceleration, in double since the sums get large
+    double matrix[3][4] = {};
+    double sumPower = 0;
+    double sumSquares = 0;
+    std::size_t used = 0;
+    for (const FeedforwardSample& sample : samples) {
+        if (std::fabs(sample.velocity) < minVelocity || !std::isfinite(sample.power) ||
+            !std::isfinite(sample.acceleration))
+            continue;
+        const double row[3] = {sample.velocity > 0 ? 1.0 : -1.0, sample.velocity, sample.acceleration};
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) matrix[i][j] += row[i] * row[j];
+            matrix[i][3] += row[i] * sample.power;
+        }
+        sumPower += sample.power;
+        sumSquares += double(sample.power) * sample.power;
+        used++;
+    }
+
+    // gaussian elimination with partial pivoting
+    for (int column = 0; column < 3; column++) {
+        int pivot = column;
+        for (int row = column + 1; row < 3; row++)
+            if (std::fabs(matrix[row][column]) > std::fabs(matrix[pivot][column])) pivot = row;
+        if (std::fabs(matrix[pivot][column]) < 1e-9) return {{}, 0, used};
+        std::swap(matrix[pivot], matrix[column]);
+        for (int row = 0; row < 3; row++) {
+            if (row == column) continue;
+            const double factor = matrix[row][column] / matrix[column][column];
+            for (int i = column; i < 4; i++) matrix[row][i] -= factor * matrix[column][i];
+        }
+    }
+    const Feedforward feedforward = {float(matrix[0][3] / matrix[0][0]), float(matrix[1][3] / matrix[1][1]),
+                                     float(matrix[2][3] / matrix[2][2])};
+
+    // compare the residuals to the spread of the power
+    double residuals = 0;
+    for (const FeedforwardSample& sample : samples) {
+        if (std::fabs(sample.velocity) < minVelocity || !std::isfinite(sample.power) ||
+            !std::isfinite(sample.acceleration))
+            continue;
+        const double error = sample.power - feedforward.calculate(sample.velocity, sample.acceleration);
+        residuals += error * error;
+    }
+    const double variance = sumSquares - sumPower * sumPower / used;
+    return {feedforward, variance > 0 ? float(1 - residuals / variance) : 0, used};
+}
+} // namespace robot
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstring>
+#include <strings.h>
+#include "pros/misc.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "robot/flightRecorder.hpp"
+
+namespace robot {
+namespace {
+/** size of every write to the SD card, in bytes */
+constexpr std::size_t BLOCK_SIZE = 4096;
+/** time between moving frames into blocks, in milliseconds */
+constexpr std::uint32_t WRITE_RATE = 20;
+/** longest a partly filled block waits before it is written anyway, in milliseconds */
+constexpr std::uint32_t FLUSH_INTERVAL = 250;
+/** largest a footer frame can get, in bytes */
+constexpr std::size_t MAX_FOOTER = 17;
+/** room for the names of the files on the SD card */
+constexpr std::int32_t LIST_SIZE = 4096;
+} // namespace
+
+FlightRecorder::FlightRecorder(std::vector<TelemetryChannel> channels, FlightRecorderSettings settings)
+    : settings(settings),
+      encoder(channels),
+      schema(encoder.schema()),
+      frame(encoder.getMaxSampleSize()),
+      ring(settings.capacity),
+      block(new std::uint8_t[BLOCK_SIZE]) {
+    // the frames already have the time and level
+    setFormat("{message}");
+}
+
+bool FlightRecorder::start() {
+    if (recording) return true;
+    if (!pros::usd::is_installed()) {
+        lemlib::infoSink()->warn("No SD card, not starting the flight recorder");
+        return false;
+    }
+    stopping = false;
+    recording = true;
+    task.emplace([this] { writeLoop(); });
+    return true;
+}
+
+void FlightRecorder::stop() {
+    stopping = true;
+    while (recording) pros::delay(5);
+}
+
+void FlightRecorder::record(std::initializer_list<float> values) {
+    if (!recording) return;
+    if (keyNeeded.exchange(false)) encoder.forceKey();
+    float samples[TELEMETRY_MAX_CHANNELS] = {};
+    std::copy_n(values.begin(), std::min(values.size(), encoder.getChannels().size()), samples);
+    const std::size_t size = encoder.encode(pros::millis(), samples, frame.data());
+    std::uint8_t* data = ring.reserve(size);
+    // the next frame can't be a difference from one that was never written
+    if (data == nullptr) {
+        encoder.forceKey();
+        return;
+    }
+    std::memcpy(data, frame.data(), size);
+    ring.commit(data, size);
+}
+
+void FlightRecorder::sendMessage(const lemlib::Message& message) {
+    if (!recording) return;
+    std::uint8_t text[TELEMETRY_MAX_TEXT_FRAME];
+    push(text, encodeTelemetryText(message.time, std::uint8_t(message.level), message.message.data(),
+                                   message.message.size(), text));
+}
+
+void FlightRecorder::push(const std::uint8_t* frame, std::size_t size) {
+    std::uint8_t* data = ring.reserve(size);
+    if (data == nullptr) return;
+    std::memcpy(data, frame, size);
+    ring.commit(data, size);
+}
+
+bool FlightRecorder::isRecording() const { return recording; }
+
+std::uint32_t FlightRecorder::getDropped() const { return ring.getDropped(); }
+
+void FlightRecorder::writeLoop() {
+    if (!openNext()) {
+        recording = false;
+        return;
+    }
+    while (!stopping && file != nullptr) {
+        drain();
+        // a crash loses whatever hasn't reached the card, so don't let a slow trickle of frames sit in the block
+        if (file != nullptr && blockUsed > flushed && pros::millis() - lastFlush >= FLUSH_INTERVAL) flushBlock();
+        pros::delay(WRITE_RATE);
+    }
+    drain();
+    close();
+    recording = false;
+}
+
+void FlightRecorder::drain() {
+    for (RingRecord record = ring.front(); record.data != nullptr && file != nullptr; record = ring.front()) {
+        // move on to the next file between frames, so every file can be decoded on its own
+        if (fileBytes + blockUsed + record.size + MAX_FOOTER > settings.fileSize && fileBytes + blockUsed > 0) {
+            close();
+            if (!openNext()) return;
+        }
+        // samples taken before the new file asked for a key frame are differences from the last file
+        const TelemetryFrame type = TelemetryFrame(record.data[2]);
+        if (type == TelemetryFrame::KEY) keyWritten = true;
+        if (type == TelemetryFrame::DELTA && !keyWritten) {
+            fileSkipped++;
+            ring.pop();
+            continue;
+        }
+        if (type == TelemetryFrame::KEY || type == TelemetryFrame::DELTA) fileSamples++;
+        append(record.data, record.size);
+        ring.pop();
+    }
+}
+
+void FlightRecorder::append(const std::uint8_t* data, std::size_t size) {
+    while (size > 0 && file != nullptr) {
+        const std::size_t count = std::min(size, BLOCK_SIZE - blockUsed);
+        std::memcpy(&block[blockUsed], data, count);
+        blockUsed += count;
+        data += count;
+        size -= count;
+        if (blockUsed == BLOCK_SIZE) writeBlock();
+    }
+}
+
+void FlightRecorder::writeBlock() {
+    putBlock();
+    blockUsed = 0;
+    fileBytes += BLOCK_SIZE;
+}
+
+void FlightRecorder::flushBlock() {
+    if (!putBlock()) return;
+    // the block is written again over the same place once it fills. If the file can't seek, the padding stays and
+    // the rest of the frames go in the next block
+    if (std::fseek(file, -long(BLOCK_SIZE), SEEK_CUR) == 0) {
+        flushed = blockUsed;
+    } else {
+        blockUsed = 0;
+        fileBytes += BLOCK_SIZE;
+    }
+}
+
+bool FlightRecorder::putBlock() {
+    // bytes after the last frame are 0, which the decoder skips
+    std::fill(&block[blockUsed], &block[BLOCK_SIZE], 0);
+    const bool written = std::fwrite(block.get(), 1, BLOCK_SIZE, file) == BLOCK_SIZE && std::fflush(file) == 0;
+    flushed = 0;
+    lastFlush = pros::millis();
+    if (!written) {
+        lemlib::infoSink()->error("Can't write {}, stopping the flight recorder", path(*index));
+        std::fclose(file);
+        file = nullptr;
+    }
+    return written;
+}
+
+bool FlightRecorder::openNext() {
+    if (!index) {
+        // continue after the newest recording on the card
+        index = 0;
+        std::vector<char> list(LIST_SIZE, 0);
+        if (pros::usd::list_files("/", list.data(), LIST_SIZE - 1) == 1) {
+            for (char* line = std::strtok(list.data(), "\n"); line != nullptr; line = std::strtok(nullptr, "\n")) {
+                unsigned number;
+                if (strncasecmp(line, settings.name.c_str(), settings.name.size()) == 0 &&
+                    std::sscanf(line + settings.name.size(), "%u", &number) == 1)
+                    index = std::max<std::uint32_t>(*index, number + 1);
+            }
+        }
+    }
+
+    file = std::fopen(path(*index).c_str(), "wb");
+    if (file == nullptr) {
+        lemlib::infoSink()->error("Can't open {}, stopping the flight recorder", path(*index));
+        return false;
+    }
+    if (*index >= settings.maxFiles) std::remove(path(*index - settings.maxFiles).c_str());
+    fileBytes = 0;
+    fileSamples = 0;
+    fileDropped = ring.getDropped();
+    fileSkipped = 0;
+    keyWritten = false;
+    keyNeeded = true;
+    append(schema.data(), schema.size());
+    return true;
+}
+
+void FlightRecorder::close() {
+    if (file == nullptr) return;
+    std::uint8_t footer[MAX_FOOTER];
+    append(footer, encodeTelemetryFooter(fileSamples, ring.getDropped() - fileDropped + fileSkipped, footer));
+    if (blockUsed > 0 && file != nullptr) writeBlock();
+    if (file != nullptr) std::fclose(file);
+    file = nullptr;
+    ++*index;
+}
+
+std::string FlightRecorder::path(std::uint32_t index) const {
+    char number[16];
+    std::snprintf(number, sizeof(number), "%04lu", static_cast<unsigned long>(index));
+    return "/usd/" + settings.name + number + ".bin";
+}
+} // namespace robot
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/error.h"
+#include "robot/imuGroup.hpp"
+
+namespace robot {
+namespace {
+/** changes in rotation further than this from the median are ignored, in degrees */
+constexpr double MAX_DISAGREEMENT = 1;
+/** ... plus this fraction of the median change */
+constexpr double MAX_DISAGREEMENT_RATIO = 0.2;
+/** the robot is still while the fused angular velocity is below this, in degrees per millisecond */
+constexpr double STILL_RATE = 0.0005;
+/** how long the robot has to be still before drift is measured, in milliseconds */
+constexpr std::uint32_t STILL_TIME = 250;
+} // namespace
+
+ImuGroup::ImuGroup(std::initializer_list<std::uint8_t> ports)
+    : pros::Imu(*ports.begin()) {
+    for (const std::uint8_t port : ports) units.push_back({pros::Imu(port)});
+    sorted.resize(units.size());
+}
+
+std::int32_t ImuGroup::reset(bool blocking) const {
+    mutex.take();
+    bool started = false;
+    for (Unit& unit : units) {
+        if (unit.imu.reset(false) != PROS_ERR) started = true;
+        unit.active = false;
+        unit.drift = 0;
+        unit.variance = 0.0001;
+    }
+    rotation = 0;
+    headingOffset = 0;
+    valid = false;
+    stillTime = 0;
+    lastUpdate = pros::millis();
+    mutex.give();
+    if (blocking) {
+        do pros::delay(10);
+        while (is_calibrating());
+    }
+    return started ? 1 : PROS_ERR;
+}
+
+bool ImuGroup::is_calibrating() const {
+    for (const Unit& unit : units)
+        if (unit.imu.get_status() != pros::ImuStatus::error && unit.imu.is_calibrating()) return true;
+    return false;
+}
+
+pros::ImuStatus ImuGroup::get_status() const {
+    if (is_calibrating()) return pros::ImuStatus::calibrating;
+    update();
+    return getActiveCount() > 0 ? pros::ImuStatus::ready : pros::ImuStatus::error;
+}
+
+void ImuGroup::update() const {
+    mutex.take();
+    const std::uint32_t now = pros::millis();
+    const std::uint32_t dt = now - lastUpdate;
+    if (dt == 0) {
+        mutex.give();
+        return;
+    }
+    lastUpdate = now;
+
+    // read every unit, dropping the ones that aren't working
+    int count = 0;
+    for (Unit& unit : units) {
+        unit.counted = false;
+        const double raw = unit.imu.get_rotation();
+        if (!std::isfinite(raw) || unit.imu.is_calibrating()) {
+            unit.active = false;
+            continue;
+        }
+        valid = true;
+        // units that just started working join with their next change, so a unit that restarted after a brown-out
+        // doesn't make the rotation jump
+        if (unit.active) {
+            unit.delta = raw - unit.previous - unit.drift * dt;
+            unit.counted = true;
+            sorted[count++] = unit.delta;
+        }
+        unit.active = true;
+        unit.previous = raw;
+    }
+    if (count == 0) {
+        mutex.give();
+        return;
+    }
+
+    // compare every change to the median change
+    std::sort(sorted.begin(), sorted.begin() + count);
+    const double median = (sorted[(count - 1) / 2] + sorted[count / 2]) / 2;
+    const double limit = MAX_DISAGREEMENT + MAX_DISAGREEMENT_RATIO * std::fabs(median);
+
+    // weighted mean of the units that agree with the median
+    double sum = 0;
+    double weights = 0;
+    double fallback = INFINITY;
+    for (Unit& unit : units) {
+        if (!unit.counted) continue;
+        if (std::fabs(unit.delta) < std::fabs(fallback)) fallback = unit.delta;
+        const double error = unit.delta - median;
+        if (std::fabs(error) > limit) continue;
+        unit.variance = std::max(unit.variance + 0.05 * (error * error - unit.variance), 0.000001);
+        sum += unit.delta / unit.variance;
+        weights += 1 / unit.variance;
+    }
+    // when no units agree, like two units that disagree, trust the one that moved the least
+    const double change = weights > 0 ? sum / weights : fallback;
+    rotation += change;
+
+    // measure the drift of every unit while the robot is still
+    stillTime = std::fabs(change) < STILL_RATE * dt ? stillTime + dt : 0;
+    if (stillTime >= STILL_TIME) {
+        for (Unit& unit : units)
+            if (unit.counted) unit.drift += 0.02 * unit.delta / dt;
+    }
+    mutex.give();
+}
+
+double ImuGroup::get_rotation() const {
+    update();
+    mutex.take();
+    const double out = valid ? rotation : PROS_ERR_F;
+    mutex.give();
+    return out;
+}
+
+double ImuGroup::get_heading() const {
+    update();
+    mutex.take();
+    const double out = valid ? std::fmod(std::fmod(rotation + headingOffset, 360) + 360, 360) : PROS_ERR_F;
+    mutex.give();
+    return out;
+}
+
+pros::imu_gyro_s_t ImuGroup::get_gyro_rate() const {
+    pros::imu_gyro_s_t out = {0, 0, 0};
+    int count = 0;
+    for (const Unit& unit : units) {
+        if (!unit.active) continue;
+        const pros::imu_gyro_s_t rate = unit.imu.get_gyro_rate();
+        if (!std::isfinite(rate.z)) continue;
+        out.x += rate.x;
+        out.y += rate.y;
+        out.z += rate.z;
+        count++;
+    }
+    if (count == 0) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    out.x /= count;
+    out.y /= count;
+    out.z /= count;
+    return out;
+}
+
+std::int32_t ImuGroup::set_data_rate(std::uint32_t rate) const {
+    std::int32_t out = PROS_ERR;
+    for (const Unit& unit : units)
+        if (unit.imu.set_data_rate(rate) != PROS_ERR) out = 1;
+    return out;
+}
+
+std::int32_t ImuGroup::set_rotation(const double target) const {
+    update();
+    mutex.take();
+    headingOffset += rotation - target;
+    rotation = target;
+    mutex.give();
+    return 1;
+}
+
+std::int32_t ImuGroup::set_heading(const double target) const {
+    update();
+    mutex.take();
+    headingOffset = target - rotation;
+    mutex.give();
+    return 1;
+}
+
+std::int32_t ImuGroup::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t ImuGroup::tare_heading() const { return set_heading(0); }
+
+int ImuGroup::getActiveCount() const {
+    mutex.take();
+    int count = 0;
+    for (const Unit& unit : units)
+        if (unit.active) count++;
+    mutex.give();
+    return count;
+}
+} // namespace robot
@@ -0,0 +1,41 @@
+#include <cmath>
+#include <initializer_list>
+#include "robot/integration.hpp"
+
+namespace robot {
+void integrate(Integrator integrator, IntegratorPose& pose, float forward, float right, float turn, float startRate,
+               float endRate, float duration) {
+    if (integrator == Integrator::RUNGE_KUTTA && duration > 0 && std::isfinite(startRate) && std::isfinite(endRate)) {
+        // heading through the step is theta + p * t + q * t^2 for t from 0 to 1, which ends at theta + turn and
+        // changes angular velocity as much as the IMU measured
+        const float q = (endRate - startRate) * duration / 2;
+        const float p = turn - q;
+        // the direction of travel doesn't depend on the position, so RK4 reduces to Simpson's rule
+        float sin = 0;
+        float cos = 0;
+        for (const float t : {0.0f, 0.5f, 1.0f}) {
+            const float weight = t == 0.5f ? 4 : 1;
+            const float heading = pose.theta + p * t + q * t * t;
+            sin += weight * std::sin(heading);
+            cos += weight * std::cos(heading);
+        }
+        sin /= 6;
+        cos /= 6;
+        pose.x += forward * sin + right * cos;
+        pose.y += forward * cos - right * sin;
+        pose.theta += turn;
+        return;
+    }
+
+    // move along the chord of the arc, at the heading halfway through the turn. sin(x) / x is replaced by its series
+    // for small turns, so there's no divide by 0 and no loss of precision
+    const float half = turn / 2;
+    const float chord = std::fabs(half) < 0.001f ? 1 - half * half / 6 : std::sin(half) / half;
+    const float heading = pose.theta + half;
+    const float sin = std::sin(heading);
+    const float cos = std::cos(heading);
+    pose.x += chord * (forward * sin + right * cos);
+    pose.y += chord * (forward * cos - right * sin);
+    pose.theta += turn;
+}
+} // namespace robot
@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <cstring>
+#include "robot/logger.hpp"
+
+namespace robot {
+namespace {
+const char* levelName(lemlib::Level level) {
+    switch (level) {
+        case lemlib::Level::INFO: return "INFO";
+        case lemlib::Level::DEBUG: return "DEBUG";
+        case lemlib::Level::WARN: return "WARN";
+        case lemlib::Level::ERROR: return "ERROR";
+        case lemlib::Level::FATAL: return "FATAL";
+    }
+    return "";
+}
+} // namespace
+
+Logger::Logger(std::size_t capacity, std::uint32_t rate)
+    : ring(capacity),
+      rate(rate),
+      task([this] {
+          while (true) {
+              flush();
+              pros::delay(this->rate);
+          }
+      }) {}
+
+void Logger::setLowestLevel(lemlib::Level level) { lowestLevel = level; }
+
+std::uint32_t Logger::getDropped() const { return ring.getDropped(); }
+
+void Logger::write(lemlib::Level level, const char* text, std::size_t length) {
+    std::uint8_t* body = reserve(level, nullptr, length);
+    if (body == nullptr) return;
+    std::memcpy(body, text, length);
+    commit(body, length);
+}
+
+std::uint8_t* Logger::reserve(lemlib::Level level, LogFormatter formatter, std::size_t size) {
+    std::uint8_t* data = ring.reserve(sizeof(LogHeader) + size);
+    if (data == nullptr) return nullptr;
+    const LogHeader header = {pros::millis(), level, formatter};
+    std::memcpy(data, &header, sizeof(LogHeader));
+    return data + sizeof(LogHeader);
+}
+
+void Logger::commit(std::uint8_t* body, std::size_t size) {
+    ring.commit(body - sizeof(LogHeader), sizeof(LogHeader) + size);
+}
+
+void Logger::flush() {
+    const std::uint32_t total = ring.getDropped();
+    for (RingRecord record = ring.front(); record.data != nullptr; record = ring.front()) {
+        LogHeader header;
+        std::memcpy(&header, record.data, sizeof(LogHeader));
+        const std::uint8_t* body = record.data + sizeof(LogHeader);
+        const char* text = reinterpret_cast<const char*>(body);
+        std::size_t length = record.size - sizeof(LogHeader);
+        // structured records are formatted now, away from the task that logged them
+        char formatted[LOG_MESSAGE_SIZE];
+        if (header.formatter != nullptr) {
+            length = header.formatter(body, formatted);
+            text = formatted;
+        }
+        std::printf("[%lu] %s: %.*s\n", static_cast<unsigned long>(header.time), levelName(header.level), int(length),
+                    text);
+        ring.pop();
+    }
+    if (total != reportedDropped) {
+        std::printf("[%lu] WARN: %lu log messages dropped\n", static_cast<unsigned long>(pros::millis()),
+                    static_cast<unsigned long>(total - reportedDropped));
+        reportedDropped = total;
+    }
+}
+
+Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+} // namespace robot
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include "robot/motionProfile.hpp"
+
+namespace robot {
+namespace {
+/** bisection steps when solving for a velocity, enough for float precision */
+constexpr int SOLVER_STEPS = 32;
+} // namespace
+
+float MotionProfile::Ramp::distance() const {
+    // the velocity of a ramp is symmetric about its middle, so it averages to halfway between its ends
+    return (startVelocity + endVelocity) / 2 * duration;
+}
+
+MotionProfile::Ramp MotionProfile::ramp(float from, float to) const {
+    const float change = std::fabs(to - from);
+    Ramp out = {from, to, 0, 0, 0};
+    if (change == 0) return out;
+    // reach the acceleration limit on the way if there's time to
+    if (change * jerk >= acceleration * acceleration) {
+        out.jerkTime = acceleration / jerk;
+        out.duration = out.jerkTime + change / acceleration;
+        out.peakAcceleration = acceleration;
+    } else {
+        out.jerkTime = std::sqrt(change / jerk);
+        out.duration = 2 * out.jerkTime;
+        out.peakAcceleration = jerk * out.jerkTime;
+    }
+    return out;
+}
+
+MotionProfile::MotionProfile(float distance, ProfileConstraints constraints, float startVelocity, float endVelocity)
+    : distance(std::fabs(distance)),
+      direction(distance < 0 ? -1 : 1),
+      acceleration(std::fabs(constraints.maxAcceleration)),
+      // an infinite jerk makes every jerk phase 0 seconds long, which is a trapezoidal profile
+      jerk(constraints.maxJerk == 0 ? INFINITY : std::fabs(constraints.maxJerk)),
+      speedUp({0, 0, 0, 0, 0}),
+      slowDown({0, 0, 0, 0, 0}) {
+    const float maxVelocity = std::fabs(constraints.maxVelocity);
+    const float start = std::clamp(startVelocity, 0.0f, maxVelocity);
+    float end = std::clamp(endVelocity, 0.0f, maxVelocity);
+
+    // if the change between the start and end velocity alone is too long, end as close to the end velocity as it can
+    if (ramp(start, end).distance() > this->distance) {
+        float low = std::min(start, end);
+        float high = std::max(start, end);
+        for (int i = 0; i < SOLVER_STEPS; i++) {
+            const float middle = (low + high) / 2;
+            // a longer change covers more distance, so move towards the start velocity when it's too long
+            const bool tooLong = ramp(start, middle).distance() > this->distance;
+            if (tooLong == (end > start)) high = middle;
+            else low = middle;
+        }
+        end = end > start ? low : high;
+        speedUp = ramp(start, end);
+        return;
+    }
+
+    // find the peak velocity. The distance of both changes grows with it
+    const float lowest = std::max(start, end);
+    const auto length = [&](float peak) { return ramp(start, peak).distance() + ramp(peak, end).distance(); };
+    float peak = maxVelocity;
+    if (length(maxVelocity) > this->distance) {
+        float low = lowest;
+        float high = maxVelocity;
+        for (int i = 0; i < SOLVER_STEPS; i++) {
+            const float middle = (low + high) / 2;
+            if (length(middle) > this->distance) high = middle;
+            else low = middle;
+        }
+        peak = low;
+    }
+    speedUp = ramp(start, peak);
+    slowDown = ramp(peak, end);
+    cruiseTime = peak > 0 ? std::max(this->distance - length(peak), 0.0f) / peak : 0;
+}
+
+ProfileState MotionProfile::sample(const Ramp& ramp, float time) const {
+    // sample the change as if it started from rest, then add the start velocity
+    const float change = std::fabs(ramp.endVelocity - ramp.startVelocity);
+    const float sign = ramp.endVelocity < ramp.startVelocity ? -1 : 1;
+    const float jerkTime = ramp.jerkTime;
+    const float peak = ramp.peakAcceleration;
+    ProfileState state = {0, 0, 0};
+    if (time < jerkTime) {
+        // acceleration ramping up
+        state = {jerk * time * time * time / 6, jerk * time * time / 2, jerk * time};
+    } else if (time < ramp.duration - jerkTime) {
+        // constant acceleration
+        state = {peak * (3 * time * time - 3 * jerkTime * time + jerkTime * jerkTime) / 6, peak * (time - jerkTime / 2),
+                 peak};
+    } else {
+        // acceleration ramping down, mirrored from the end of the change
+        const float remaining = ramp.duration - time;
+        const float rampJerk = jerkTime > 0 ? jerk : 0;
+        state = {change * ramp.duration / 2 - change * remaining + rampJerk * remaining * remaining * remaining / 6,
+                 change - rampJerk * remaining * remaining / 2, rampJerk * remaining};
+    }
+    return {ramp.startVelocity * time + sign * state.position, ramp.startVelocity + sign * state.velocity,
+            sign * state.acceleration};
+}
+
+ProfileState MotionProfile::sample(float time) const {
+    time = std::max(time, 0.0f);
+    ProfileState state = {0, 0, 0};
+    const float cruiseStart = speedUp.duration;
+    const float slowDownStart = cruiseStart + cruiseTime;
+    if (time < cruiseStart) {
+        state = sample(speedUp, time);
+    } else if (time < slowDownStart) {
+        state = {speedUp.distance() + speedUp.endVelocity * (time - cruiseStart), speedUp.endVelocity, 0};
+    } else if (time < getDuration()) {
+        const ProfileState change = sample(slowDown, time - slowDownStart);
+        state = {speedUp.distance() + speedUp.endVelocity * cruiseTime + change.position, change.velocity,
+                 change.acceleration};
+    } else {
+        // continue at the end velocity
+        state = {distance + endSpeed() * (time - getDuration()), endSpeed(), 0};
+    }
+    return {state.position * direction, state.velocity * direction, state.acceleration * direction};
+}
+
+float MotionProfile::getDuration() const { return speedUp.duration + cruiseTime + slowDown.duration; }
+
+float MotionProfile::getDistance() const { return distance * direction; }
+
+float MotionProfile::getEndVelocity() const { return endSpeed() * direction; }
+
+float MotionProfile::endSpeed() const {
+    return slowDown.duration > 0 || slowDown.endVelocity > 0 ? slowDown.endVelocity : speedUp.endVelocity;
+}
+} // namespace robot
@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "robot/integration.hpp"
+#include "robot/odom.hpp"
+#include "robot/poseFilter.hpp"
+#include "robot/sampleStream.hpp"
+
+namespace robot {
+namespace {
+/** how often the odometry sensors produce new samples, in milliseconds */
+constexpr std::uint32_t DATA_RATE = 10;
+/** the oldest a stalled sensor may hold back the common instant, in milliseconds */
+constexpr double MAX_LAG = 3 * DATA_RATE;
+
+pros::Task* trackingTask = nullptr;
+pros::Mutex statsMutex;
+OdomStats stats;
+std::uint64_t totalExecution = 0;
+std::uint32_t period = 10;
+
+OdomMode requestedMode = OdomMode::LEMLIB;
+OdomMode activeMode = OdomMode::LEMLIB;
+bool sensorsChanged = false;
+
+struct Wheel {
+        lemlib::TrackingWheel* wheel = nullptr;
+        SampleStream stream {DATA_RATE};
+        /** distance at the instant of the last update */
+        float previous = 0;
+};
+
+Wheel vertical1;
+Wheel vertical2;
+Wheel horizontal1;
+Wheel horizontal2;
+pros::Imu* imu = nullptr;
+SampleStream imuStream {DATA_RATE};
+float previousImu = 0;
+/** angular velocity from the IMU, clockwise in radians per second */
+SampleStream imuRateStream {DATA_RATE};
+float previousRate = NAN;
+Integrator integrator = Integrator::EXPONENTIAL;
+pros::MotorGroup* leftMotors = nullptr;
+pros::MotorGroup* rightMotors = nullptr;
+
+/** pose integrated in ALIGNED mode, theta in radians */
+float x = 0;
+float y = 0;
+float theta = 0;
+/** the pose last given to lemlib::setPose */
+float publishedX = 0;
+float publishedY = 0;
+float publishedTheta = 0;
+/** instant of the last update, in milliseconds */
+double alignedTime = 0;
+
+/** meters to inches */
+constexpr float METERS = 39.3701;
+
+pros::Gps* gps = nullptr;
+float gpsMaxError = 0.05;
+double gpsX = 0;
+double gpsY = 0;
+pros::Mutex filterMutex;
+PoseFilter filter;
+/** the pose at the end of the last loop, nan until the filter has been started */
+lemlib::Pose filteredPose(NAN, NAN, NAN);
+
+pros::Mutex correctionMutex;
+/** corrections added since the last update, theta in radians */
+float correctionX = 0;
+float correctionY = 0;
+float correctionTheta = 0;
+
+/**
+ * @brief The pose and velocity after one update. Theta is in radians, velocities are per second
+ */
+struct PoseRecord {
+        double time = 0;
+        float x = 0;
+        float y = 0;
+        float theta = 0;
+        float speedX = 0;
+        float speedY = 0;
+        float speedTheta = 0;
+};
+
+/**
+ * @brief One slot of the pose history
+ *
+ * Only the odometry task writes to the history. The sequence number is odd while a slot is being written, so
+ * readers can tell when they read a half-written record and read it again.
+ */
+struct HistorySlot {
+        std::atomic<std::uint32_t> sequence {0};
+        PoseRecord record;
+};
+
+std::array<HistorySlot, POSE_HISTORY_SIZE> history;
+/** number of records ever written */
+std::atomic<std::uint32_t> historyCount {0};
+
+/**
+ * @brief Record the timing of one loop
+ *
+ * @param scheduled time the loop should have started, in microseconds
+ * @param start time the loop started, in microseconds
+ * @param end time the update finished, in microseconds
+ * @param overrun whether the next loop was already due when the update finished
+ */
+void record(std::uint64_t scheduled, std::uint64_t start, std::uint64_t end, bool overrun) {
+    statsMutex.take();
+    const std::uint32_t execution = end - start;
+    const std::uint32_t jitter = start > scheduled ? start - scheduled : 0;
+    stats.period = period;
+    stats.loops++;
+    stats.lastExecution = execution;
+    stats.maxExecution = std::max(stats.maxExecution, execution);
+    totalExecution += execution;
+    stats.meanExecution = float(totalExecution) / stats.loops;
+    stats.maxJitter = std::max(stats.maxJitter, jitter);
+    if (overrun) stats.overruns++;
+    statsMutex.give();
+}
+
+/**
+ * @brief Add the latest reading of a tracking wheel to its sample history
+ *
+ * Wheels that use the drive motors take the timestamp the motors report. LemLib gives the left side a negative
+ * offset, which is how the motor group is found.
+ */
+void sample(Wheel& wheel, double now) {
+    if (wheel.wheel == nullptr) return;
+    const float distance = wheel.wheel->getDistanceTraveled();
+    if (wheel.wheel->getType() == 1) {
+        pros::MotorGroup* motors = wheel.wheel->getOffset() < 0 ? leftMotors : rightMotors;
+        std::uint32_t timestamp = 0;
+        motors->get_raw_position(&timestamp);
+        wheel.stream.push(distance, timestamp);
+    } else {
+        wheel.stream.poll(distance, now);
+    }
+}
+
+/**
+ * @brief Start the sample histories from the current readings and the pose from LemLib's
+ */
+void startAligned() {
+    const double now = pros::micros() / 1000.0;
+    for (Wheel* wheel : {&vertical1, &vertical2, &horizontal1, &horizontal2}) {
+        if (wheel->wheel == nullptr) continue;
+        wheel->previous = wheel->wheel->getDistanceTraveled();
+        wheel->stream.reset(wheel->previous, now);
+    }
+    if (imu != nullptr) {
+        const double rotation = imu->get_rotation();
+        previousImu = std::isinf(rotation) ? 0 : rotation * M_PI / 180;
+        imuStream.reset(previousImu, now);
+        const double rate = imu->get_gyro_rate().z;
+        previousRate = std::isinf(rate) ? 0 : rate * M_PI / 180;
+        imuRateStream.reset(previousRate, now);
+    }
+    const lemlib::Pose pose = lemlib::getPose(true);
+    x = publishedX = pose.x;
+    y = publishedY = pose.y;
+    theta = publishedTheta = pose.theta;
+    alignedTime = now;
+}
+
+/**
+ * @brief Integrate the motion between the last instant and the newest instant every sensor has reached
+ *
+ * The math is the same as lemlib::update, including which sensors are used to calculate the heading.
+ */
+void alignedUpdate() {
+    // pick up poses set through LemLib
+    const lemlib::Pose current = lemlib::getPose(true);
+    if (current.x != publishedX || current.y != publishedY || current.theta != publishedTheta) {
+        x = current.x;
+        y = current.y;
+        theta = current.theta;
+    }
+
+    // sample every sensor and find the newest instant all of them have reached
+    const double now = pros::micros() / 1000.0;
+    double time = now;
+    for (Wheel* wheel : {&vertical1, &vertical2, &horizontal1, &horizontal2}) {
+        if (wheel->wheel == nullptr) continue;
+        sample(*wheel, now);
+        time = std::min(time, wheel->stream.latest());
+    }
+    if (imu != nullptr) {
+        const double rotation = imu->get_rotation();
+        if (!std::isinf(rotation)) imuStream.poll(rotation * M_PI / 180, now);
+        const double rate = imu->get_gyro_rate().z;
+        if (!std::isinf(rate)) imuRateStream.poll(rate * M_PI / 180, now);
+        time = std::min(time, imuStream.latest());
+    }
+    // a sensor that stopped updating shouldn't stop odometry
+    time = std::max(time, now - MAX_LAG);
+    if (time <= alignedTime) return;
+    const double previousTime = alignedTime;
+    alignedTime = time;
+
+    // resample every sensor at that instant
+    float deltas[4] = {0, 0, 0, 0};
+    Wheel* wheels[4] = {&vertical1, &vertical2, &horizontal1, &horizontal2};
+    for (int i = 0; i < 4; i++) {
+        if (wheels[i]->wheel == nullptr) continue;
+        const float distance = wheels[i]->stream.at(time);
+        deltas[i] = distance - wheels[i]->previous;
+        wheels[i]->previous = distance;
+    }
+    const float deltaVertical1 = deltas[0];
+    const float deltaVertical2 = deltas[1];
+    const float deltaHorizontal1 = deltas[2];
+    const float deltaHorizontal2 = deltas[3];
+    float deltaImu = 0;
+    float rate = NAN;
+    if (imu != nullptr) {
+        const float rotation = imuStream.at(time);
+        deltaImu = rotation - previousImu;
+        previousImu = rotation;
+        rate = imuRateStream.at(time);
+    }
+
+    // calculate the heading, in the same order of priority as LemLib
+    float heading = theta;
+    if (horizontal1.wheel != nullptr && horizontal2.wheel != nullptr)
+        heading -= (deltaHorizontal1 - deltaHorizontal2) /
+                   (horizontal1.wheel->getOffset() - horizontal2.wheel->getOffset());
+    else if (!vertical1.wheel->getType() && !vertical2.wheel->getType())
+        heading -= (deltaVertical1 - deltaVertical2) / (vertical1.wheel->getOffset() - vertical2.wheel->getOffset());
+    else if (imu != nullptr) heading += deltaImu;
+    else
+        heading -= (deltaVertical1 - deltaVertical2) / (vertical1.wheel->getOffset() - vertical2.wheel->getOffset());
+    const float deltaHeading = heading - theta;
+
+    // prioritize unpowered tracking wheels
+    float deltaY = deltaVertical1;
+    float verticalOffset = vertical1.wheel->getOffset();
+    if (vertical1.wheel->getType() && !vertical2.wheel->getType()) {
+        deltaY = deltaVertical2;
+        verticalOffset = vertical2.wheel->getOffset();
+    }
+    float deltaX = 0;
+    float horizontalOffset = 0;
+    if (horizontal1.wheel != nullptr) {
+        deltaX = deltaHorizontal1;
+        horizontalOffset = horizontal1.wheel->getOffset();
+    } else if (horizontal2.wheel != nullptr) {
+        deltaX = deltaHorizontal2;
+        horizontalOffset = horizontal2.wheel->getOffset();
+    }
+
+    // integrate the distance the tracking center travelled. LemLib's horizontal wheels measure to the left
+    IntegratorPose pose = {x, y, theta};
+    integrate(integrator, pose, deltaY + verticalOffset * deltaHeading, -(deltaX + horizontalOffset * deltaHeading),
+              deltaHeading, previousRate, rate, (time - previousTime) / 1000);
+    previousRate = rate;
+    x = pose.x;
+    y = pose.y;
+    theta = pose.theta;
+
+    lemlib::setPose(lemlib::Pose(x, y, theta), true);
+    publishedX = x;
+    publishedY = y;
+    publishedTheta = theta;
+}
+
+/**
+ * @brief Feed the odometry step to the pose filter, and correct the pose with the GPS
+ *
+ * @param before pose before the odometry update, theta in radians
+ */
+void filterUpdate(const lemlib::Pose& before) {
+    const lemlib::Pose after = lemlib::getPose(true);
+    filterMutex.take();
+    // the pose was set, so start over from it
+    if (before.x != filteredPose.x || before.y != filteredPose.y || before.theta != filteredPose.theta)
+        filter.reset(before.x, before.y, before.theta);
+    filter.predict(after.x - before.x, after.y - before.y, after.theta - before.theta);
+
+    // only use new fixes the GPS is confident in
+    if (gps != nullptr) {
+        const pros::gps_status_s_t status = gps->get_position_and_orientation();
+        const double heading = gps->get_heading();
+        const double error = gps->get_error();
+        if (std::isfinite(status.x) && std::isfinite(heading) && error <= gpsMaxError &&
+            (status.x != gpsX || status.y != gpsY)) {
+            gpsX = status.x;
+            gpsY = status.y;
+            const float variance = std::pow(std::max(error, 0.005) * METERS, 2);
+            // the heading is much more reliable than the position, while the robot isn't spinning fast
+            if (filter.correct(status.x * METERS, status.y * METERS, heading * M_PI / 180, variance, 0.0003))
+                lemlib::setPose(lemlib::Pose(filter.getX(), filter.getY(), filter.getTheta()), true);
+        }
+    }
+
+    // apply corrections from other tasks
+    correctionMutex.take();
+    if (correctionX != 0 || correctionY != 0 || correctionTheta != 0) {
+        const lemlib::Pose pose = lemlib::getPose(true);
+        lemlib::setPose(lemlib::Pose(pose.x + correctionX, pose.y + correctionY, pose.theta + correctionTheta), true);
+        filter.shift(correctionX, correctionY, correctionTheta);
+        correctionX = correctionY = correctionTheta = 0;
+    }
+    correctionMutex.give();
+    filteredPose = lemlib::getPose(true);
+    filterMutex.give();
+}
+
+/**
+ * @brief Add the current pose to the history
+ *
+ * The speeds come from how far odometry moved the robot, not from the change in the pose, so corrections and
+ * setPose don't show up as a burst of speed.
+ *
+ * @param time the instant the pose describes, in milliseconds
+ * @param moved how far odometry moved the robot since the last record, theta in radians
+ */
+void recordPose(double time, const lemlib::Pose& moved) {
+    const lemlib::Pose pose = lemlib::getPose(true);
+    const std::uint32_t count = historyCount.load(std::memory_order_relaxed);
+    PoseRecord record;
+    record.time = time;
+    record.x = pose.x;
+    record.y = pose.y;
+    record.theta = pose.theta;
+    if (count != 0) {
+        const PoseRecord& last = history[(count - 1) % POSE_HISTORY_SIZE].record;
+        const float dt = (time - last.time) / 1000;
+        if (dt <= 0) return;
+        record.speedX = moved.x / dt;
+        record.speedY = moved.y / dt;
+        record.speedTheta = moved.theta / dt;
+    }
+
+    HistorySlot& slot = history[count % POSE_HISTORY_SIZE];
+    slot.sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = record;
+    slot.sequence.fetch_add(1, std::memory_order_release);
+    historyCount.store(count + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Read a record from the history without blocking the odometry task
+ *
+ * @param index number of the record, counting from the first record ever written
+ */
+PoseRecord readHistory(std::uint32_t index) {
+    const HistorySlot& slot = history[index % POSE_HISTORY_SIZE];
+    while (true) {
+        const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        const PoseRecord record = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (before % 2 == 0 && slot.sequence.load(std::memory_order_relaxed) == before) return record;
+        // the odometry task was interrupted while writing this slot, so let it finish
+        pros::delay(1);
+    }
+}
+
+/**
+ * @brief Interpolate the history at a timestamp
+ *
+ * @param timestamp the instant, in milliseconds
+ */
+PoseRecord lookup(double timestamp) {
+    const std::uint32_t count = historyCount.load(std::memory_order_acquire);
+    if (count == 0) {
+        const lemlib::Pose pose = lemlib::getPose(true);
+        PoseRecord record;
+        record.x = pose.x;
+        record.y = pose.y;
+        record.theta = pose.theta;
+        return record;
+    }
+    // skip the oldest slot, since it is the next one to be overwritten
+    std::uint32_t low = count > POSE_HISTORY_SIZE ? count - POSE_HISTORY_SIZE + 1 : 0;
+    std::uint32_t high = count - 1;
+    PoseRecord after = readHistory(high);
+    if (timestamp >= after.time) return after;
+    PoseRecord before = readHistory(low);
+    if (timestamp <= before.time) return before;
+
+    // binary search for the records around the timestamp
+    while (high - low > 1) {
+        const std::uint32_t middle = low + (high - low) / 2;
+        const PoseRecord record = readHistory(middle);
+        if (record.time <= timestamp) {
+            low = middle;
+            before = record;
+        } else {
+            high = middle;
+            after = record;
+        }
+    }
+
+    const float t = (timestamp - before.time) / (after.time - before.time);
+    PoseRecord out;
+    out.time = timestamp;
+    out.x = before.x + (after.x - before.x) * t;
+    out.y = before.y + (after.y - before.y) * t;
+    out.theta = before.theta + (after.theta - before.theta) * t;
+    out.speedX = before.speedX + (after.speedX - before.speedX) * t;
+    out.speedY = before.speedY + (after.speedY - before.speedY) * t;
+    out.speedTheta = before.speedTheta + (after.speedTheta - before.speedTheta) * t;
+    return out;
+}
+
+void trackingLoop() {
+    std::uint32_t next = pros::millis();
+    while (true) {
+        const std::uint64_t scheduled = std::uint64_t(next) * 1000;
+        const std::uint64_t start = pros::micros();
+        if (requestedMode != activeMode || sensorsChanged) {
+            sensorsChanged = false;
+            activeMode = requestedMode;
+            if (activeMode == OdomMode::ALIGNED) {
+                startAligned();
+            } else {
+                // lemlib::update integrates from the readings it saw last, so bring them up to date
+                const lemlib::Pose pose = lemlib::getPose(true);
+                lemlib::update();
+                lemlib::setPose(pose, true);
+            }
+        }
+        const lemlib::Pose before = lemlib::getPose(true);
+        if (activeMode == OdomMode::ALIGNED) alignedUpdate();
+        else lemlib::update();
+        const lemlib::Pose after = lemlib::getPose(true);
+        filterUpdate(before);
+        recordPose(activeMode == OdomMode::ALIGNED ? alignedTime : start / 1000.0,
+                   lemlib::Pose(after.x - before.x, after.y - before.y, after.theta - before.theta));
+        const std::uint64_t end = pros::micros();
+
+        // skip the loops we missed instead of running them back to back
+        const bool overrun = pros::millis() >= next + period;
+        if (overrun) next = pros::millis();
+        record(scheduled, start, end, overrun);
+        pros::Task::delay_until(&next, period);
+    }
+}
+} // namespace
+
+void initOdom(lemlib::OdomSensors sensors, lemlib::Drivetrain drivetrain, std::uint32_t period) {
+    lemlib::setSensors(sensors, drivetrain);
+    vertical1.wheel = sensors.vertical1;
+    vertical2.wheel = sensors.vertical2;
+    horizontal1.wheel = sensors.horizontal1;
+    horizontal2.wheel = sensors.horizontal2;
+    imu = sensors.imu;
+    leftMotors = drivetrain.leftMotors;
+    rightMotors = drivetrain.rightMotors;
+    sensorsChanged = true;
+    robot::period = std::max<std::uint32_t>(period, 1);
+    if (trackingTask == nullptr) trackingTask = new pros::Task(trackingLoop, "Odometry");
+}
+
+void setOdomMode(OdomMode mode) { requestedMode = mode; }
+
+void setOdomIntegrator(Integrator integrator) { robot::integrator = integrator; }
+
+OdomMode getOdomMode() { return requestedMode; }
+
+void setGps(pros::Gps* gps, float maxError) {
+    filterMutex.take();
+    robot::gps = gps;
+    gpsMaxError = maxError;
+    filterMutex.give();
+}
+
+void correctPose(lemlib::Pose correction, bool radians) {
+    correctionMutex.take();
+    correctionX += correction.x;
+    correctionY += correction.y;
+    correctionTheta += radians ? correction.theta : correction.theta * M_PI / 180;
+    correctionMutex.give();
+}
+
+lemlib::Pose getPoseAt(std::uint32_t timestamp, bool radians) {
+    const PoseRecord record = lookup(timestamp);
+    return lemlib::Pose(record.x, record.y, radians ? record.theta : record.theta * 180 / M_PI);
+}
+
+lemlib::Pose getSpeedAt(std::uint32_t timestamp, bool radians) {
+    const PoseRecord record = lookup(timestamp);
+    return lemlib::Pose(record.speedX, record.speedY, radians ? record.speedTheta : record.speedTheta * 180 / M_PI);
+}
+
+PoseCovariance getPoseCovariance() {
+    filterMutex.take();
+    const PoseCovariance out = filter.getCovariance();
+    filterMutex.give();
+    return out;
+}
+
+OdomStats getOdomStats() {
+    statsMutex.take();
+    OdomStats out = stats;
+    statsMutex.give();
+    out.period = period;
+    return out;
+}
+
+void resetOdomStats() {
+    statsMutex.take();
+    stats = OdomStats();
+    totalExecution = 0;
+    statsMutex.give();
+}
+} // namespace robot
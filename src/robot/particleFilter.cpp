@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+#include "robot/particleFilter.hpp"
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace robot {
+namespace {
+/** the distance sensor can't see further than 2 meters, in inches */
+constexpr float MAX_RANGE = 78.7;
+/** chance that a reading is explained by the map, versus something else the beam hit */
+constexpr float HIT = 0.9;
+constexpr float RANDOM = 0.1;
+/** odometry noise, as fractions of the step */
+constexpr float DISTANCE_NOISE = 0.05;
+constexpr float TURN_NOISE = 0.05;
+/** heading noise per inch travelled, in radians */
+constexpr float DRIFT_NOISE = 0.002;
+
+/**
+ * @brief Keep the distance to a vertical segment for every particle whose beam hits it closer than before
+ *
+ * The same function handles horizontal segments with x and y swapped
+ *
+ * @param position coordinate of the segment on the axis it is perpendicular to
+ * @param low the smaller end of the segment on the other axis
+ * @param high the larger end of the segment on the other axis
+ */
+void castSegment(float position, float low, float high, const float* __restrict sensorX,
+                 const float* __restrict sensorY, const float* __restrict inverseX,
+                 const float* __restrict directionY, float* __restrict expected, std::size_t count) {
+    std::size_t i = 0;
+#ifdef __ARM_NEON
+    const float32x4_t positions = vdupq_n_f32(position);
+    const float32x4_t lows = vdupq_n_f32(low);
+    const float32x4_t highs = vdupq_n_f32(high);
+    const float32x4_t zeros = vdupq_n_f32(0);
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t distance = vmulq_f32(vsubq_f32(positions, vld1q_f32(sensorX + i)), vld1q_f32(inverseX + i));
+        const float32x4_t hit = vmlaq_f32(vld1q_f32(sensorY + i), distance, vld1q_f32(directionY + i));
+        const uint32x4_t valid =
+            vandq_u32(vcgtq_f32(distance, zeros), vandq_u32(vcgeq_f32(hit, lows), vcleq_f32(hit, highs)));
+        const float32x4_t current = vld1q_f32(expected + i);
+        vst1q_f32(expected + i, vbslq_f32(valid, vminq_f32(current, distance), current));
+    }
+#endif
+    for (; i < count; i++) {
+        const float distance = (position - sensorX[i]) * inverseX[i];
+        const float hit = sensorY[i] + distance * directionY[i];
+        if (distance > 0 && hit >= low && hit <= high && distance < expected[i]) expected[i] = distance;
+    }
+}
+} // namespace
+
+ParticleFilter::ParticleFilter(std::vector<MapSegment> map, std::vector<BeamMount> beams, std::size_t count,
+                               std::uint32_t seed)
+    : beams(beams),
+      count((std::max<std::size_t>(count, 1) + 3) / 4 * 4),
+      random(seed == 0 ? 1 : seed) {
+    for (const MapSegment& segment : map) {
+        if (segment.x0 == segment.x1) verticalSegments.push_back(segment);
+        else if (segment.y0 == segment.y1) horizontalSegments.push_back(segment);
+    }
+    for (std::vector<float>* array : {&x, &y, &theta, &sinTheta, &cosTheta, &weight, &sensorX, &sensorY, &directionX,
+                                      &directionY, &inverseX, &inverseY, &expected, &resampledX, &resampledY,
+                                      &resampledTheta})
+        array->resize(this->count);
+    reset(0, 0, 0);
+}
+
+float ParticleFilter::uniform() {
+    // xorshift32
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return (random >> 8) * (1.0f / 16777216);
+}
+
+float ParticleFilter::gaussian() {
+    // the sum of 4 uniform numbers is close enough to normal, and much cheaper than Box-Muller
+    return (uniform() + uniform() + uniform() + uniform() - 2) * 1.7320508f;
+}
+
+void ParticleFilter::reset(float x, float y, float theta, float spread, float thetaSpread) {
+    for (std::size_t i = 0; i < count; i++) {
+        this->x[i] = x + gaussian() * spread;
+        this->y[i] = y + gaussian() * spread;
+        this->theta[i] = theta + gaussian() * thetaSpread;
+        sinTheta[i] = std::sin(this->theta[i]);
+        cosTheta[i] = std::cos(this->theta[i]);
+        weight[i] = 1.0f / count;
+    }
+}
+
+void ParticleFilter::predict(float forward, float right, float turn) {
+    const float distance = std::hypot(forward, right);
+    const float distanceNoise = DISTANCE_NOISE * distance;
+    const float turnNoise = TURN_NOISE * std::fabs(turn) + DRIFT_NOISE * distance;
+    for (std::size_t i = 0; i < count; i++) {
+        const float scale = 1 + gaussian() * DISTANCE_NOISE;
+        const float noisyForward = forward * scale;
+        const float noisyRight = right * scale + gaussian() * distanceNoise * 0.5f;
+        // move along the heading halfway through the turn
+        const float heading = theta[i] + turn / 2;
+        const float s = std::sin(heading);
+        const float c = std::cos(heading);
+        x[i] += noisyForward * s + noisyRight * c;
+        y[i] += noisyForward * c - noisyRight * s;
+        theta[i] += turn + gaussian() * turnNoise;
+        sinTheta[i] = std::sin(theta[i]);
+        cosTheta[i] = std::cos(theta[i]);
+    }
+}
+
+void ParticleFilter::castBeam(const BeamMount& beam) {
+    const float angle = beam.angle * float(M_PI) / 180;
+    const float sinAngle = std::sin(angle);
+    const float cosAngle = std::cos(angle);
+    for (std::size_t i = 0; i < count; i++) {
+        sensorX[i] = x[i] + beam.x * cosTheta[i] + beam.y * sinTheta[i];
+        sensorY[i] = y[i] - beam.x * sinTheta[i] + beam.y * cosTheta[i];
+        // sin and cos of the beam heading from the angle sum identities
+        directionX[i] = sinTheta[i] * cosAngle + cosTheta[i] * sinAngle;
+        directionY[i] = cosTheta[i] * cosAngle - sinTheta[i] * sinAngle;
+        inverseX[i] = 1 / directionX[i];
+        inverseY[i] = 1 / directionY[i];
+        expected[i] = MAX_RANGE;
+    }
+    for (const MapSegment& segment : verticalSegments)
+        castSegment(segment.x0, std::min(segment.y0, segment.y1), std::max(segment.y0, segment.y1), sensorX.data(),
+                    sensorY.data(), inverseX.data(), directionY.data(), expected.data(), count);
+    for (const MapSegment& segment : horizontalSegments)
+        castSegment(segment.y0, std::min(segment.x0, segment.x1), std::max(segment.x0, segment.x1), sensorY.data(),
+                    sensorX.data(), inverseY.data(), directionX.data(), expected.data(), count);
+}
+
+float ParticleFilter::correct(const float* ranges) {
+    bool used = false;
+    for (std::size_t beam = 0; beam < beams.size(); beam++) {
+        const float range = ranges[beam];
+        if (std::isnan(range)) continue;
+        used = true;
+        castBeam(beams[beam]);
+        // the distance sensor is accurate to about 5% of the distance
+        const float sigma = 0.5f + 0.05f * range;
+        const float scale = -0.5f / (sigma * sigma);
+        for (std::size_t i = 0; i < count; i++) {
+            const float error = range - expected[i];
+            weight[i] *= HIT * std::exp(error * error * scale) + RANDOM;
+        }
+    }
+    if (!used) return count;
+
+    // normalize the weights
+    float sum = 0;
+    for (std::size_t i = 0; i < count; i++) sum += weight[i];
+    if (!(sum > 0) || !std::isfinite(sum)) {
+        std::fill(weight.begin(), weight.end(), 1.0f / count);
+        return 0;
+    }
+    float squares = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        weight[i] /= sum;
+        squares += weight[i] * weight[i];
+    }
+
+    // only resample when the weights have become uneven, resampling too often loses diversity
+    const float effective = 1 / squares;
+    if (effective < count / 2.0f) resample();
+    return effective;
+}
+
+void ParticleFilter::resample() {
+    // low variance resampling: one random number, evenly spaced picks
+    const float step = 1.0f / count;
+    float target = uniform() * step;
+    float cumulative = weight[0];
+    std::size_t source = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        while (target > cumulative && source < count - 1) cumulative += weight[++source];
+        resampledX[i] = x[source];
+        resampledY[i] = y[source];
+        resampledTheta[i] = theta[source];
+        target += step;
+    }
+    x.swap(resampledX);
+    y.swap(resampledY);
+    theta.swap(resampledTheta);
+    for (std::size_t i = 0; i < count; i++) {
+        sinTheta[i] = std::sin(theta[i]);
+        cosTheta[i] = std::cos(theta[i]);
+        weight[i] = step;
+    }
+}
+
+ParticleFilter::Estimate ParticleFilter::estimate() const {
+    Estimate out = {0, 0, 0};
+    for (std::size_t i = 0; i < count; i++) {
+        out.x += weight[i] * x[i];
+        out.y += weight[i] * y[i];
+        out.theta += weight[i] * theta[i];
+    }
+    return out;
+}
+
+std::size_t ParticleFilter::size() const { return count; }
+} // namespace robot
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "robot/path.hpp"
+
+namespace robot {
+namespace {
+/** points closer together than this are the same point, in inches */
+constexpr float MIN_SPACING = 0.001;
+constexpr float INCHES_PER_METER = 39.3701;
+/** longest step the profile is integrated with, in seconds */
+constexpr float STEP = 0.002;
+/** slowest a point's speed from the path file may limit the profile to, as a fraction of the max velocity */
+constexpr float MIN_SPEED = 0.05;
+} // namespace
+
+std::vector<PathPoint> parsePath(const asset& path) {
+    std::vector<PathPoint> points;
+    const char* data = reinterpret_cast<const char*>(path.buf);
+    std::size_t start = 0;
+    while (start < path.size) {
+        // copy the line so parsing can't run past the end of the asset, which isn't null terminated
+        std::size_t end = start;
+        while (end < path.size && data[end] != '\n') end++;
+        char line[64];
+        const std::size_t length = std::min(end - start, sizeof(line) - 1);
+        std::memcpy(line, data + start, length);
+        line[length] = '\0';
+        start = end + 1;
+
+        if (std::strncmp(line, "endData", 7) == 0) break;
+        char* cursor = line;
+        char* next;
+        float values[3];
+        int count = 0;
+        for (; count < 3; count++) {
+            values[count] = std::strtof(cursor, &next);
+            if (next == cursor) break;
+            cursor = next;
+            while (*cursor == ',' || *cursor == ' ') cursor++;
+        }
+        if (count < 3) continue;
+
+        const PathPoint point = {values[0], values[1], values[2], 0, 0};
+        if (!points.empty() &&
+            std::hypot(point.x - points.back().x, point.y - points.back().y) < MIN_SPACING)
+            continue;
+        points.push_back(point);
+        // the rest of the path is only there for pure pursuit's lookahead
+        if (point.speed == 0 && points.size() > 1) break;
+    }
+    measurePath(points);
+    return points;
+}
+
+void measurePath(std::vector<PathPoint>& points) {
+    const std::size_t count = points.size();
+    for (std::size_t i = 0; i < count; i++) {
+        points[i].distance =
+            i == 0 ? 0
+                   : points[i - 1].distance + std::hypot(points[i].x - points[i - 1].x, points[i].y - points[i - 1].y);
+        points[i].curvature = 0;
+    }
+    if (count < 3) return;
+    // curvature of the circle through each point and its neighbours
+    for (std::size_t i = 1; i + 1 < count; i++) {
+        const PathPoint& a = points[i - 1];
+        const PathPoint& b = points[i];
+        const PathPoint& c = points[i + 1];
+        const float cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+        const float product = std::hypot(b.x - a.x, b.y - a.y) * std::hypot(c.x - b.x, c.y - b.y) *
+                              std::hypot(c.x - a.x, c.y - a.y);
+        // the cross product is positive counterclockwise, LemLib turns clockwise
+        points[i].curvature = product > 0 ? -2 * cross / product : 0;
+    }
+    points.front().curvature = points[1].curvature;
+    points.back().curvature = points[count - 2].curvature;
+}
+
+PathView::PathView(const PathPoint* points, std::size_t count)
+    : points(points),
+      count(count) {}
+
+PathView PathView::fromBinary(const void* data, std::size_t size) {
+    if (data == nullptr || size < sizeof(PathHeader) ||
+        reinterpret_cast<std::uintptr_t>(data) % alignof(PathHeader) != 0)
+        return {};
+    const PathHeader* header = static_cast<const PathHeader*>(data);
+    if (header->magic != PATH_MAGIC || header->count > (size - sizeof(PathHeader)) / sizeof(PathPoint)) return {};
+    return {reinterpret_cast<const PathPoint*>(header + 1), header->count};
+}
+
+std::size_t PathView::size() const { return count; }
+
+const PathPoint& PathView::operator[](std::size_t index) const { return points[index]; }
+
+PathIndex::PathIndex(PathView points, float window)
+    : points(points),
+      window(window) {}
+
+PathIndex::Projection PathIndex::closest(float x, float y) {
+    const std::size_t count = points.size();
+    if (count == 0) return {0, 0, x, y};
+    if (count == 1) return {0, 0, points[0].x, points[0].y};
+
+    // project onto every segment that starts within the window
+    const float limit = points[closestSegment].distance + window;
+    Projection best = {closestSegment, 0, 0, 0};
+    float bestSquared = INFINITY;
+    for (std::size_t i = closestSegment; i + 1 < count && (i == closestSegment || points[i].distance <= limit); i++) {
+        const PathPoint& from = points[i];
+        const PathPoint& to = points[i + 1];
+        const float segmentX = to.x - from.x;
+        const float segmentY = to.y - from.y;
+        const float squaredLength = segmentX * segmentX + segmentY * segmentY;
+        const float along = (x - from.x) * segmentX + (y - from.y) * segmentY;
+        const float t = squaredLength > 0 ? std::clamp(along / squaredLength, 0.0f, 1.0f) : 0;
+        const float projectedX = from.x + segmentX * t;
+        const float projectedY = from.y + segmentY * t;
+        const float squared = (x - projectedX) * (x - projectedX) + (y - projectedY) * (y - projectedY);
+        if (squared < bestSquared) {
+            bestSquared = squared;
+            best = {i, from.distance + (to.distance - from.distance) * t, projectedX, projectedY};
+        }
+    }
+    closestSegment = best.segment;
+    return best;
+}
+
+PathPoint PathIndex::at(float distance) {
+    const std::size_t count = points.size();
+    if (count == 0) return {0, 0, 0, 0, 0};
+    if (count == 1) return points[0];
+
+    // walk the cursor to the segment that contains the distance
+    while (cursor > 0 && points[cursor].distance > distance) cursor--;
+    while (cursor + 2 < count && points[cursor + 1].distance < distance) cursor++;
+    const PathPoint& from = points[cursor];
+    const PathPoint& to = points[cursor + 1];
+    const float length = to.distance - from.distance;
+    const float t = length > 0 ? std::clamp((distance - from.distance) / length, 0.0f, 1.0f) : 0;
+    return {from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t, from.speed + (to.speed - from.speed) * t,
+            from.curvature + (to.curvature - from.curvature) * t, from.distance + length * t};
+}
+
+void PathIndex::reset() {
+    closestSegment = 0;
+    cursor = 0;
+}
+
+PathProfile::PathProfile(PathView points, PathConstraints constraints, float startVelocity, float endVelocity)
+    : points(points),
+      constraints(constraints),
+      endVelocity(std::clamp(endVelocity, 0.0f, constraints.maxVelocity)) {
+    this->constraints.maxAcceleration = std::fabs(constraints.maxAcceleration);
+    velocity = std::clamp(startVelocity, 0.0f, constraints.maxVelocity);
+}
+
+float PathProfile::pointLimit(std::size_t index) const {
+    if (index + 1 >= points.size()) return endVelocity;
+    const PathPoint& point = points[index];
+    const float curvature = std::fabs(point.curvature);
+    // a speed of 0 anywhere but the end, like on the first point of a path, would keep the robot from ever moving
+    float limit = constraints.maxVelocity * std::clamp(point.speed / 127, MIN_SPEED, 1.0f);
+    limit = std::min(limit, constraints.maxVelocity / (1 + curvature * constraints.trackWidth / 2));
+    if (curvature > 0) limit = std::min(limit, std::sqrt(constraints.maxLateralAcceleration / curvature));
+    return limit;
+}
+
+float PathProfile::limit() const {
+    // points further than it takes to stop from top speed can't slow the robot down
+    const float acceleration = constraints.maxAcceleration;
+    const float reach = constraints.maxVelocity * constraints.maxVelocity / (2 * acceleration);
+    float out = std::min(pointLimit(segment), constraints.maxVelocity);
+    for (std::size_t i = segment + 1; i < points.size(); i++) {
+        const float ahead = points[i].distance - distance;
+        if (ahead > reach) break;
+        const float next = pointLimit(i);
+        out = std::min(out, std::sqrt(next * next + 2 * acceleration * std::max(ahead, 0.0f)));
+    }
+    return out;
+}
+
+float PathProfile::heading(std::size_t index) const {
+    const std::size_t last = points.size() - 1;
+    const std::size_t before = index == 0 ? 0 : index - 1;
+    const std::size_t after = index == last ? last : index + 1;
+    const float in = std::atan2(points[index].x - points[before].x, points[index].y - points[before].y);
+    const float out = std::atan2(points[after].x - points[index].x, points[after].y - points[index].y);
+    if (index == 0) return out;
+    if (index == last) return in;
+    return in + std::remainder(out - in, 2 * M_PI) / 2;
+}
+
+PathProfile::State PathProfile::sample(float time) {
+    const std::size_t count = points.size();
+    if (count == 0) return {0, 0, 0, 0, 0, 0};
+    if (count == 1) return {points[0].x, points[0].y, 0, 0, 0, 0};
+
+    // integrate up to the time, speeding up as fast as allowed without passing the limit
+    const float end = points[count - 1].distance;
+    // leftover slivers of time are skipped, the acceleration over them would be noise
+    while (time - this->time > STEP / 10) {
+        const float step = std::min(STEP, time - this->time);
+        const float previous = velocity;
+        velocity = std::max(std::min(velocity + constraints.maxAcceleration * step, limit()), 0.0f);
+        acceleration = (velocity - previous) / step;
+        distance = std::min(distance + (previous + velocity) / 2 * step, end);
+        if (distance >= end) {
+            velocity = endVelocity;
+            acceleration = 0;
+        }
+        while (segment + 2 < count && points[segment + 1].distance <= distance) segment++;
+        this->time += step;
+    }
+
+    const PathPoint& from = points[segment];
+    const PathPoint& to = points[segment + 1];
+    const float length = to.distance - from.distance;
+    const float t = length > 0 ? std::clamp((distance - from.distance) / length, 0.0f, 1.0f) : 1;
+    const float start = heading(segment);
+    const float turn = std::remainder(heading(segment + 1) - start, 2 * M_PI);
+    const float curvature = from.curvature + (to.curvature - from.curvature) * t;
+    return {from.x + (to.x - from.x) * t,
+            from.y + (to.y - from.y) * t,
+            start + turn * t,
+            velocity,
+            velocity * curvature,
+            acceleration};
+}
+
+bool PathProfile::isDone() const { return points.size() < 2 || distance >= points[points.size() - 1].distance; }
+
+float PathProfile::getDistance() const { return distance; }
+
+std::size_t PathProfile::size() const { return points.size(); }
+
+ChassisSpeeds ramsete(const PathProfile::State& target, float x, float y, float theta, float b, float zeta) {
+    // error in the robot's frame
+    const float deltaX = target.x - x;
+    const float deltaY = target.y - y;
+    const float forward = deltaX * std::sin(theta) + deltaY * std::cos(theta);
+    const float right = deltaX * std::cos(theta) - deltaY * std::sin(theta);
+    const float turn = std::remainder(target.theta - theta, 2 * M_PI);
+
+    // b is per square meter like the paper, the errors are in inches
+    const float beta = b / (INCHES_PER_METER * INCHES_PER_METER);
+    const float gain = 2 * zeta *
+                       std::sqrt(target.angularVelocity * target.angularVelocity +
+                                 beta * target.velocity * target.velocity);
+    const float sinc = std::fabs(turn) < 0.001f ? 1 - turn * turn / 6 : std::sin(turn) / turn;
+    return {target.velocity * std::cos(turn) + gain * forward,
+            target.angularVelocity + gain * turn + beta * target.velocity * sinc * right};
+}
+} // namespace robot
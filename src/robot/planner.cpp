@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "robot/planner.hpp"
+
+namespace robot {
+namespace {
+constexpr float SQRT2 = 1.41421356;
+/** most corners added to a spline before settling for straight lines */
+constexpr int MAX_REFINEMENTS = 32;
+/** distance over which the end of the path slows down, in inches */
+constexpr float SLOWDOWN_DISTANCE = 18;
+/** slowest the end of the path gets, in motor power, so pure pursuit still reaches it */
+constexpr float MIN_END_SPEED = 30;
+/** points closer together than this are the same point, in inches. Same as parsePath */
+constexpr float MIN_SPACING = 0.001;
+
+/**
+ * @brief Get the distance from a position to a box, negative inside it
+ */
+float boxDistance(const Obstacle& box, float x, float y) {
+    const float outsideX = std::max({box.x0 - x, 0.0f, x - box.x1});
+    const float outsideY = std::max({box.y0 - y, 0.0f, y - box.y1});
+    if (outsideX > 0 || outsideY > 0) return std::hypot(outsideX, outsideY);
+    return -std::min({x - box.x0, box.x1 - x, y - box.y0, box.y1 - y});
+}
+} // namespace
+
+PathPlanner::PathPlanner(std::vector<Obstacle> obstacles, PlannerSettings settings)
+    : obstacles(obstacles),
+      settings(settings) {
+    for (Obstacle& box : this->obstacles) {
+        if (box.x0 > box.x1) std::swap(box.x0, box.x1);
+        if (box.y0 > box.y1) std::swap(box.y0, box.y1);
+    }
+    this->settings.resolution = std::max(settings.resolution, 0.5f);
+    this->settings.spacing = std::max(settings.spacing, 0.1f);
+    columns = std::uint32_t(std::max(settings.right - settings.left, 0.0f) / this->settings.resolution) + 1;
+    rows = std::uint32_t(std::max(settings.top - settings.bottom, 0.0f) / this->settings.resolution) + 1;
+
+    const std::size_t count = std::size_t(columns) * rows;
+    clearances.resize(count);
+    for (std::uint32_t cell = 0; cell < count; cell++) clearances[cell] = clearanceAt(cellX(cell), cellY(cell));
+    costs.resize(count);
+    parents.resize(count);
+    visits.assign(count, 0);
+}
+
+float PathPlanner::clearanceAt(float x, float y) const {
+    float out = std::min({x - settings.left, settings.right - x, y - settings.bottom, settings.top - y});
+    for (const Obstacle& box : obstacles) out = std::min(out, boxDistance(box, x, y));
+    return out;
+}
+
+std::uint32_t PathPlanner::cellAt(float x, float y) const {
+    const float column = std::clamp(std::round((x - settings.left) / settings.resolution), 0.0f, float(columns - 1));
+    const float row = std::clamp(std::round((y - settings.bottom) / settings.resolution), 0.0f, float(rows - 1));
+    return std::uint32_t(row) * columns + std::uint32_t(column);
+}
+
+float PathPlanner::cellX(std::uint32_t cell) const { return settings.left + (cell % columns) * settings.resolution; }
+
+float PathPlanner::cellY(std::uint32_t cell) const { return settings.bottom + (cell / columns) * settings.resolution; }
+
+std::pair<float, float> PathPlanner::position(std::size_t index) const {
+    if (index == 0) return {startX, startY};
+    if (index + 1 == cells.size()) return {targetX, targetY};
+    return {cellX(cells[index]), cellY(cells[index])};
+}
+
+bool PathPlanner::search(std::uint32_t start, std::uint32_t goal) {
+    // cells not visited in this search have stale costs, which saves clearing them every search
+    if (++visit == 0) {
+        std::fill(visits.begin(), visits.end(), 0);
+        visit = 1;
+    }
+    const auto heuristic = [&](std::uint32_t cell) {
+        // octile distance, the length of the shortest lattice path without obstacles
+        const float deltaX = std::fabs(float(cell % columns) - float(goal % columns));
+        const float deltaY = std::fabs(float(cell / columns) - float(goal / columns));
+        return (std::max(deltaX, deltaY) + (SQRT2 - 1) * std::min(deltaX, deltaY)) * settings.resolution;
+    };
+    // a cell can be entered if it's clear, or if it leads away from the obstacle the robot starts in
+    const auto canEnter = [&](std::uint32_t from, std::uint32_t to) {
+        return clearances[to] >= settings.clearance || clearances[to] > clearances[from];
+    };
+
+    open.clear();
+    costs[start] = 0;
+    parents[start] = start;
+    visits[start] = visit;
+    open.push_back({heuristic(start), start});
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<>());
+        const auto [estimate, cell] = open.back();
+        open.pop_back();
+        // skip cells that were reached by a shorter way after being queued
+        if (estimate > costs[cell] + heuristic(cell) + 1e-3f) continue;
+        if (cell == goal) break;
+
+        const int column = cell % columns;
+        const int row = cell / columns;
+        for (int deltaY = -1; deltaY <= 1; deltaY++) {
+            for (int deltaX = -1; deltaX <= 1; deltaX++) {
+                if (deltaX == 0 && deltaY == 0) continue;
+                const int nextColumn = column + deltaX;
+                const int nextRow = row + deltaY;
+                if (nextColumn < 0 || nextRow < 0 || nextColumn >= int(columns) || nextRow >= int(rows)) continue;
+                const std::uint32_t next = nextRow * columns + nextColumn;
+                if (!canEnter(cell, next)) continue;
+                // don't cut the corners of obstacles diagonally, unless already escaping one
+                if (deltaX != 0 && deltaY != 0 && clearances[cell] >= settings.clearance &&
+                    (!canEnter(cell, row * columns + nextColumn) || !canEnter(cell, nextRow * columns + column)))
+                    continue;
+                const float cost = costs[cell] + (deltaX != 0 && deltaY != 0 ? SQRT2 : 1) * settings.resolution;
+                if (visits[next] == visit && costs[next] <= cost) continue;
+                visits[next] = visit;
+                costs[next] = cost;
+                parents[next] = cell;
+                open.push_back({cost + heuristic(next), next});
+                std::push_heap(open.begin(), open.end(), std::greater<>());
+            }
+        }
+    }
+    if (visits[goal] != visit) return false;
+
+    cells.clear();
+    for (std::uint32_t cell = goal; cell != start; cell = parents[cell]) cells.push_back(cell);
+    cells.push_back(start);
+    std::reverse(cells.begin(), cells.end());
+    return true;
+}
+
+bool PathPlanner::isClear(float x0, float y0, float x1, float y1, float minClearance) const {
+    const float length = std::hypot(x1 - x0, y1 - y0);
+    const int steps = int(std::ceil(length / (settings.resolution / 2)));
+    for (int i = 0; i <= steps; i++) {
+        const float t = steps > 0 ? float(i) / steps : 0;
+        if (clearanceAt(x0 + (x1 - x0) * t, y0 + (y1 - y0) * t) < minClearance) return false;
+    }
+    return true;
+}
+
+std::size_t PathPlanner::sample(bool smooth, float minClearance) {
+    path.clear();
+    const std::size_t last = corners.size() - 1;
+    // tangent of the spline at a corner, no longer than the segments on either side so it can't overshoot
+    const auto tangent = [&](std::size_t corner) -> std::pair<float, float> {
+        if (!smooth) return {0, 0};
+        const auto [x, y] = position(corners[corner]);
+        const auto [beforeX, beforeY] = position(corners[corner == 0 ? 0 : corner - 1]);
+        const auto [afterX, afterY] = position(corners[std::min(corner + 1, last)]);
+        const float length = std::min(corner == 0 ? INFINITY : std::hypot(x - beforeX, y - beforeY),
+                                      corner == last ? INFINITY : std::hypot(afterX - x, afterY - y));
+        float directionX = afterX - beforeX;
+        float directionY = afterY - beforeY;
+        if (corner == 0) {
+            directionX = startDirectionX;
+            directionY = startDirectionY;
+        } else if (corner == last && (targetDirectionX != 0 || targetDirectionY != 0)) {
+            directionX = targetDirectionX;
+            directionY = targetDirectionY;
+        }
+        const float norm = std::hypot(directionX, directionY);
+        if (norm == 0 || std::isinf(length)) return {0, 0};
+        return {directionX / norm * length, directionY / norm * length};
+    };
+
+    for (std::size_t corner = 0; corner < last; corner++) {
+        // cubic Hermite segment between two corners
+        const auto [x0, y0] = position(corners[corner]);
+        const auto [x1, y1] = position(corners[corner + 1]);
+        const auto [tangentX0, tangentY0] = tangent(corner);
+        const auto [tangentX1, tangentY1] = tangent(corner + 1);
+        // the curve is a little longer than the straight line
+        const int steps = std::max(1, int(std::ceil(std::hypot(x1 - x0, y1 - y0) * 1.2f / settings.spacing)));
+        for (int i = 0; i <= steps; i++) {
+            const float t = float(i) / steps;
+            const float t2 = t * t;
+            const float t3 = t2 * t;
+            const float start = 2 * t3 - 3 * t2 + 1;
+            const float startTangent = t3 - 2 * t2 + t;
+            const float end = -2 * t3 + 3 * t2;
+            const float endTangent = t3 - t2;
+            const float x = start * x0 + startTangent * tangentX0 + end * x1 + endTangent * tangentX1;
+            const float y = start * y0 + startTangent * tangentY0 + end * y1 + endTangent * tangentY1;
+            if (smooth && clearanceAt(x, y) < minClearance) return corner;
+            if (!path.empty() && std::hypot(x - path.back().x, y - path.back().y) < MIN_SPACING) continue;
+            path.push_back({x, y, settings.speed, 0, 0});
+        }
+    }
+    return corners.size();
+}
+
+PathView PathPlanner::plan(float x, float y, float theta, float targetX, float targetY, float targetTheta,
+                           bool forwards) {
+    path.clear();
+    const std::uint32_t start = cellAt(x, y);
+    const std::uint32_t goal = cellAt(targetX, targetY);
+    if (clearances[goal] < settings.clearance || !search(start, goal)) return {};
+
+    const float sign = forwards ? 1 : -1;
+    this->startX = x;
+    this->startY = y;
+    this->targetX = targetX;
+    this->targetY = targetY;
+    startDirectionX = sign * std::sin(theta);
+    startDirectionY = sign * std::cos(theta);
+    targetDirectionX = std::isnan(targetTheta) ? 0 : sign * std::sin(targetTheta);
+    targetDirectionY = std::isnan(targetTheta) ? 0 : sign * std::cos(targetTheta);
+    // starting too close to an obstacle is fine as long as the path doesn't get any closer
+    const float minClearance =
+        std::min({settings.clearance, clearanceAt(x, y), clearanceAt(targetX, targetY)}) - 1e-3f;
+
+    // the start and the target are in the same cell
+    if (cells.size() == 1) cells.push_back(cells[0]);
+
+    // pull the lattice path tight: keep going straight until the next cell can't be seen
+    corners.clear();
+    corners.push_back(0);
+    while (corners.back() + 1 < cells.size()) {
+        const std::size_t from = corners.back();
+        const auto [fromX, fromY] = position(from);
+        std::size_t to = from + 1;
+        while (to + 1 < cells.size()) {
+            const auto [nextX, nextY] = position(to + 1);
+            if (!isClear(fromX, fromY, nextX, nextY, minClearance)) break;
+            to++;
+        }
+        corners.push_back(to);
+    }
+
+    // curve through the corners, adding corners from the lattice path where the curve swings too close
+    bool smooth = true;
+    for (int refinement = 0;; refinement++) {
+        const std::size_t blocked = sample(smooth, minClearance);
+        if (blocked == corners.size()) break;
+        const std::size_t from = corners[blocked];
+        const std::size_t to = corners[blocked + 1];
+        if (to - from < 2 || refinement == MAX_REFINEMENTS) {
+            // join every cell of the lattice path with straight lines, which the search already checked
+            smooth = false;
+            corners.resize(cells.size());
+            for (std::size_t i = 0; i < cells.size(); i++) corners[i] = i;
+            continue;
+        }
+        corners.insert(corners.begin() + blocked + 1, (from + to) / 2);
+    }
+    if (path.size() < 2) {
+        path.clear();
+        return {};
+    }
+
+    // slow down towards the end
+    measurePath(path);
+    const float length = path.back().distance;
+    for (PathPoint& point : path) {
+        const float remaining = length - point.distance;
+        if (remaining < SLOWDOWN_DISTANCE)
+            point.speed = std::min(settings.speed,
+                                   std::max(settings.speed * remaining / SLOWDOWN_DISTANCE, MIN_END_SPEED));
+    }
+    return {path.data(), path.size()};
+}
+} // namespace robot
@@ -0,0 +1,117 @@
+#include <cmath>
+#include "robot/poseFilter.hpp"
+
+namespace robot {
+namespace {
+/** 99th percentile of the chi-squared distribution with 3 degrees of freedom */
+constexpr float GATE = 11.34;
+
+PoseCovariance multiply(const PoseCovariance& a, const PoseCovariance& b) {
+    PoseCovariance out {};
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            for (int k = 0; k < 3; k++) out[i][j] += a[i][k] * b[k][j];
+    return out;
+}
+
+/**
+ * @brief Invert a symmetric 3x3 matrix
+ *
+ * @return false the matrix is singular
+ */
+bool invert(const PoseCovariance& m, PoseCovariance& out) {
+    const float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    const float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    const float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    const float determinant = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+    if (determinant == 0 || !std::isfinite(determinant)) return false;
+    const float scale = 1 / determinant;
+    out[0][0] = c00 * scale;
+    out[1][0] = c01 * scale;
+    out[2][0] = c02 * scale;
+    out[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * scale;
+    out[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * scale;
+    out[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * scale;
+    out[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * scale;
+    out[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * scale;
+    out[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * scale;
+    return true;
+}
+} // namespace
+
+PoseFilter::PoseFilter(float distanceVariance, float turnVariance, float driftVariance)
+    : distanceVariance(distanceVariance),
+      turnVariance(turnVariance),
+      driftVariance(driftVariance) {}
+
+void PoseFilter::reset(float x, float y, float theta, float positionVariance, float headingVariance) {
+    this->x = x;
+    this->y = y;
+    this->theta = theta;
+    covariance = {};
+    covariance[0][0] = positionVariance;
+    covariance[1][1] = positionVariance;
+    covariance[2][2] = headingVariance;
+}
+
+void PoseFilter::shift(float deltaX, float deltaY, float deltaTheta) {
+    x += deltaX;
+    y += deltaY;
+    theta += deltaTheta;
+}
+
+void PoseFilter::predict(float deltaX, float deltaY, float deltaTheta) {
+    x += deltaX;
+    y += deltaY;
+    theta += deltaTheta;
+
+    // a heading error rotates the whole step, so the jacobian couples theta into x and y
+    // the motion is dx = ly * sin(theta) - lx * cos(theta), dy = ly * cos(theta) + lx * sin(theta)
+    const PoseCovariance jacobian = {{{1, 0, deltaY}, {0, 1, -deltaX}, {0, 0, 1}}};
+    const PoseCovariance transposed = {{{1, 0, 0}, {0, 1, 0}, {deltaY, -deltaX, 1}}};
+    covariance = multiply(multiply(jacobian, covariance), transposed);
+
+    const float distance = std::hypot(deltaX, deltaY);
+    covariance[0][0] += distanceVariance * distance;
+    covariance[1][1] += distanceVariance * distance;
+    covariance[2][2] += turnVariance * std::fabs(deltaTheta) + driftVariance * distance;
+}
+
+bool PoseFilter::correct(float x, float y, float theta, float positionVariance, float headingVariance) {
+    // the measurement is the pose itself, so the innovation covariance is P + R
+    PoseCovariance innovationCovariance = covariance;
+    innovationCovariance[0][0] += positionVariance;
+    innovationCovariance[1][1] += positionVariance;
+    innovationCovariance[2][2] += headingVariance;
+    PoseCovariance inverse;
+    if (!invert(innovationCovariance, inverse)) return false;
+
+    const float innovation[3] = {x - this->x, y - this->y, std::remainder(theta - this->theta, float(2 * M_PI))};
+    float distance = 0;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) distance += innovation[i] * inverse[i][j] * innovation[j];
+    if (!(distance < GATE)) return false;
+
+    const PoseCovariance gain = multiply(covariance, inverse);
+    this->x += gain[0][0] * innovation[0] + gain[0][1] * innovation[1] + gain[0][2] * innovation[2];
+    this->y += gain[1][0] * innovation[0] + gain[1][1] * innovation[1] + gain[1][2] * innovation[2];
+    this->theta += gain[2][0] * innovation[0] + gain[2][1] * innovation[1] + gain[2][2] * innovation[2];
+
+    // P = (I - K) P, kept symmetric
+    PoseCovariance identityMinusGain {};
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) identityMinusGain[i][j] = (i == j) - gain[i][j];
+    const PoseCovariance updated = multiply(identityMinusGain, covariance);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) covariance[i][j] = (updated[i][j] + updated[j][i]) / 2;
+    return true;
+}
+
+float PoseFilter::getX() const { return x; }
+
+float PoseFilter::getY() const { return y; }
+
+float PoseFilter::getTheta() const { return theta; }
+
+PoseCovariance PoseFilter::getCovariance() const { return covariance; }
+} // namespace robot
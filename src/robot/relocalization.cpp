@@ -0,0 +1,214 @@
+#include <cmath>
+#include "pros/error.h"
+#include "robot/odom.hpp"
+#include "robot/relocalization.hpp"
+
+namespace robot {
+namespace {
+/** about how old a distance reading is when it is read, in milliseconds */
+constexpr std::uint32_t SENSOR_LATENCY = 20;
+/** the distance sensor isn't accurate past 2 meters, in millimeters */
+constexpr std::int32_t MAX_RANGE = 2000;
+/** fastest the robot may turn for readings to be used, in radians per second */
+constexpr float MAX_TURN_RATE = 1.5;
+/** odometry steps longer than this are poses being set, in inches */
+constexpr float MAX_STEP = 12;
+
+/**
+ * @brief Read a distance sensor, in inches
+ *
+ * @return NaN if the reading is out of range or not confident enough
+ */
+float readDistance(pros::Distance* sensor, int minConfidence) {
+    const std::int32_t distance = sensor->get_distance();
+    const std::int32_t confidence = sensor->get_confidence();
+    if (distance == PROS_ERR || distance <= 0 || distance > MAX_RANGE || confidence == PROS_ERR ||
+        confidence < minConfidence)
+        return NAN;
+    return distance / 25.4;
+}
+
+std::vector<BeamMount> beamMounts(const std::vector<DistanceMount>& sensors) {
+    std::vector<BeamMount> out;
+    for (const DistanceMount& mount : sensors) out.push_back({mount.x, mount.y, mount.angle});
+    return out;
+}
+} // namespace
+
+std::vector<MapSegment> wallSegments(FieldWalls walls) {
+    return {{walls.left, walls.bottom, walls.left, walls.top},
+            {walls.right, walls.bottom, walls.right, walls.top},
+            {walls.left, walls.bottom, walls.right, walls.bottom},
+            {walls.left, walls.top, walls.right, walls.top}};
+}
+
+WallRelocalizer::WallRelocalizer(std::vector<DistanceMount> sensors, FieldWalls walls, float rate, int minConfidence,
+                                 float band, float maxIncidence)
+    : sensors(sensors),
+      walls(walls),
+      rate(rate),
+      minConfidence(minConfidence),
+      band(band),
+      minCosine(std::cos(maxIncidence * M_PI / 180)) {}
+
+int WallRelocalizer::update() {
+    // use the pose the robot had when the sensors sampled
+    const std::uint32_t time = pros::millis() - SENSOR_LATENCY;
+    const lemlib::Pose pose = getPoseAt(time, true);
+    if (std::fabs(getSpeedAt(time, true).theta) > MAX_TURN_RATE) {
+        rejected += sensors.size();
+        return 0;
+    }
+
+    float sumX = 0;
+    float sumY = 0;
+    int countX = 0;
+    int countY = 0;
+    for (const DistanceMount& mount : sensors) {
+        const float measured = readDistance(mount.sensor, minConfidence);
+        if (std::isnan(measured)) {
+            rejected++;
+            continue;
+        }
+
+        // where the sensor is on the field and where it points
+        const float sensorX = pose.x + mount.x * std::cos(pose.theta) + mount.y * std::sin(pose.theta);
+        const float sensorY = pose.y - mount.x * std::sin(pose.theta) + mount.y * std::cos(pose.theta);
+        const float beam = pose.theta + mount.angle * M_PI / 180;
+        const float directionX = std::sin(beam);
+        const float directionY = std::cos(beam);
+
+        // find the wall the beam should hit first
+        float toVertical = INFINITY;
+        float toHorizontal = INFINITY;
+        if (directionX > 0) toVertical = (walls.right - sensorX) / directionX;
+        else if (directionX < 0) toVertical = (walls.left - sensorX) / directionX;
+        if (directionY > 0) toHorizontal = (walls.top - sensorY) / directionY;
+        else if (directionY < 0) toHorizontal = (walls.bottom - sensorY) / directionY;
+        const bool vertical = toVertical < toHorizontal;
+        const float expected = vertical ? toVertical : toHorizontal;
+        const float cosine = std::fabs(vertical ? directionX : directionY);
+        if (expected <= 0 || cosine < minCosine || std::fabs(measured - expected) > band) {
+            rejected++;
+            continue;
+        }
+
+        // the sensor is really measured inches from the wall, so move it along the wall's normal
+        accepted++;
+        if (vertical) {
+            sumX += (expected - measured) * directionX;
+            countX++;
+        } else {
+            sumY += (expected - measured) * directionY;
+            countY++;
+        }
+    }
+
+    if (countX + countY == 0) return 0;
+    const float correctionX = countX == 0 ? 0 : rate * sumX / countX;
+    const float correctionY = countY == 0 ? 0 : rate * sumY / countY;
+    correctPose(lemlib::Pose(correctionX, correctionY, 0), true);
+    return countX + countY;
+}
+
+void WallRelocalizer::start(std::uint32_t period) {
+    if (task != nullptr) return;
+    stopping = false;
+    running = true;
+    task = new pros::Task([this, period] {
+        std::uint32_t next = pros::millis();
+        while (!stopping) {
+            update();
+            pros::Task::delay_until(&next, period);
+        }
+        running = false;
+    });
+}
+
+void WallRelocalizer::stop() {
+    if (task == nullptr) return;
+    // removing the task could kill it while it holds the odometry's correction mutex
+    stopping = true;
+    while (running) pros::delay(5);
+    delete task;
+    task = nullptr;
+}
+
+std::uint32_t WallRelocalizer::getAccepted() const { return accepted; }
+
+std::uint32_t WallRelocalizer::getRejected() const { return rejected; }
+
+ParticleRelocalizer::ParticleRelocalizer(std::vector<DistanceMount> sensors, std::vector<MapSegment> map,
+                                         std::size_t particles, float rate, int minConfidence)
+    : sensors(sensors),
+      filter(map, beamMounts(sensors), particles),
+      rate(rate),
+      minConfidence(minConfidence),
+      ranges(sensors.size()) {}
+
+float ParticleRelocalizer::update() {
+    // use the pose the robot had when the sensors sampled
+    const lemlib::Pose pose = getPoseAt(pros::millis() - SENSOR_LATENCY, true);
+    const float deltaX = pose.x - lastX;
+    const float deltaY = pose.y - lastY;
+    const float deltaTheta = pose.theta - lastTheta;
+    if (!started || std::hypot(deltaX, deltaY) > MAX_STEP) {
+        filter.reset(pose.x, pose.y, pose.theta);
+        started = true;
+    } else {
+        // odometry moved along the heading halfway through the step, in the robot's frame
+        const float heading = lastTheta + deltaTheta / 2;
+        filter.predict(deltaX * std::sin(heading) + deltaY * std::cos(heading),
+                       deltaX * std::cos(heading) - deltaY * std::sin(heading), deltaTheta);
+    }
+
+    bool measured = false;
+    for (std::size_t i = 0; i < sensors.size(); i++) {
+        ranges[i] = readDistance(sensors[i].sensor, minConfidence);
+        if (!std::isnan(ranges[i])) measured = true;
+    }
+    const float effective = filter.correct(ranges.data());
+    // without readings the particles only spread by the prediction noise, and with collapsed weights their mean
+    // means nothing, so leave odometry alone
+    if (!measured || effective == 0) {
+        lastX = pose.x;
+        lastY = pose.y;
+        lastTheta = pose.theta;
+        return effective;
+    }
+
+    // pull odometry towards the particles
+    const ParticleFilter::Estimate estimate = filter.estimate();
+    const float correctionX = rate * (estimate.x - pose.x);
+    const float correctionY = rate * (estimate.y - pose.y);
+    const float correctionTheta = rate * (estimate.theta - pose.theta);
+    correctPose(lemlib::Pose(correctionX, correctionY, correctionTheta), true);
+    lastX = pose.x + correctionX;
+    lastY = pose.y + correctionY;
+    lastTheta = pose.theta + correctionTheta;
+    return effective;
+}
+
+void ParticleRelocalizer::start(std::uint32_t period) {
+    if (task != nullptr) return;
+    stopping = false;
+    running = true;
+    task = new pros::Task([this, period] {
+        std::uint32_t next = pros::millis();
+        while (!stopping) {
+            update();
+            pros::Task::delay_until(&next, period);
+        }
+        running = false;
+    });
+}
+
+void ParticleRelocalizer::stop() {
+    if (task == nullptr) return;
+    // removing the task could kill it while it holds the odometry's correction mutex
+    stopping = true;
+    while (running) pros::delay(5);
+    delete task;
+    task = nullptr;
+}
+} // namespace robot
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cstring>
+#include "robot/ringBuffer.hpp"
+
+namespace robot {
+namespace {
+/** set in the header of a committed record. A header of 0 hasn't been committed yet */
+constexpr std::uint32_t WRITTEN = 1u << 31;
+/** set in the header of the space skipped before a record that starts over at the beginning */
+constexpr std::uint32_t SKIP = 1u << 30;
+constexpr std::uint32_t SIZE_MASK = SKIP - 1;
+constexpr std::uint32_t HEADER_SIZE = sizeof(std::uint32_t);
+
+/**
+ * @brief Get the space a record takes in the ring, with its header and rounded up to whole words
+ */
+std::uint32_t footprint(std::size_t size) { return (HEADER_SIZE + size + 3) & ~std::uint32_t(3); }
+} // namespace
+
+RingBuffer::RingBuffer(std::size_t capacity)
+    : capacity(HEADER_SIZE) {
+    while (this->capacity < capacity) this->capacity *= 2;
+    // zeroed, so every header starts out uncommitted
+    words.reset(new std::uint32_t[this->capacity / HEADER_SIZE]());
+}
+
+std::uint8_t* RingBuffer::reserve(std::size_t size) {
+    const std::uint32_t length = footprint(size);
+    std::uint32_t start = head.load(std::memory_order_relaxed);
+    std::uint32_t offset;
+    std::uint32_t claimed;
+    do {
+        offset = start & (capacity - 1);
+        const std::uint32_t toEnd = capacity - offset;
+        claimed = length <= toEnd ? length : toEnd + length;
+        const std::uint32_t used = start - tail.load(std::memory_order_acquire);
+        if (size > SIZE_MASK || used + claimed > capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            droppedBytes.fetch_add(length, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!head.compare_exchange_weak(start, start + claimed, std::memory_order_acq_rel,
+                                         std::memory_order_relaxed));
+
+    const std::uint32_t used = start + claimed - tail.load(std::memory_order_relaxed);
+    std::uint32_t peak = highWater.load(std::memory_order_relaxed);
+    while (used > peak && !highWater.compare_exchange_weak(peak, used, std::memory_order_relaxed));
+
+    if (claimed != length) {
+        // the record doesn't fit before the end, skip to the beginning
+        std::atomic_ref<std::uint32_t>(words[offset / HEADER_SIZE])
+            .store(WRITTEN | SKIP | (capacity - offset), std::memory_order_release);
+        offset = 0;
+    }
+    return reinterpret_cast<std::uint8_t*>(&words[offset / HEADER_SIZE + 1]);
+}
+
+void RingBuffer::commit(std::uint8_t* data, std::size_t size) {
+    std::uint32_t* header = reinterpret_cast<std::uint32_t*>(data) - 1;
+    std::atomic_ref<std::uint32_t>(*header).store(WRITTEN | std::uint32_t(size), std::memory_order_release);
+}
+
+RingRecord RingBuffer::front() {
+    while (true) {
+        const std::uint32_t start = tail.load(std::memory_order_relaxed);
+        if (start == head.load(std::memory_order_acquire)) return {};
+        std::uint32_t* header = &words[(start & (capacity - 1)) / HEADER_SIZE];
+        const std::uint32_t value = std::atomic_ref<std::uint32_t>(*header).load(std::memory_order_acquire);
+        if (!(value & WRITTEN)) return {};
+        if (!(value & SKIP)) return {reinterpret_cast<const std::uint8_t*>(header + 1), value & SIZE_MASK};
+        // writers find the next header as 0 only if removed space is cleared
+        std::memset(header, 0, value & SIZE_MASK);
+        tail.store(start + (value & SIZE_MASK), std::memory_order_release);
+    }
+}
+
+void RingBuffer::pop() {
+    const std::uint32_t start = tail.load(std::memory_order_relaxed);
+    std::uint32_t* header = &words[(start & (capacity - 1)) / HEADER_SIZE];
+    const std::uint32_t value = std::atomic_ref<std::uint32_t>(*header).load(std::memory_order_relaxed);
+    if (!(value & WRITTEN)) return;
+    const std::uint32_t length = footprint(value & SIZE_MASK);
+    std::memset(header, 0, length);
+    tail.store(start + length, std::memory_order_release);
+}
+
+std::uint32_t RingBuffer::getDropped() const { return dropped; }
+
+std::uint32_t RingBuffer::getDroppedBytes() const { return droppedBytes; }
+
+std::uint32_t RingBuffer::getHighWater() const { return highWater; }
+} // namespace robot
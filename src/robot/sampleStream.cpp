@@ -0,0 +1,61 @@
+#include <algorithm>
+#include "robot/sampleStream.hpp"
+
+namespace robot {
+SampleStream::SampleStream(std::uint32_t dataRate)
+    : dataRate(dataRate) {}
+
+void SampleStream::reset(float value, double time) {
+    count = 0;
+    add(value, time);
+    lastPoll = time;
+}
+
+void SampleStream::add(float value, double time) {
+    newest = (newest + 1) % samples.size();
+    samples[newest] = {value, time};
+    if (count < samples.size()) count++;
+}
+
+void SampleStream::push(float value, double time) {
+    if (count != 0 && time <= samples[newest].time) return;
+    add(value, time);
+}
+
+void SampleStream::poll(float value, double now) {
+    if (count == 0) {
+        reset(value, now);
+        return;
+    }
+    const Sample& last = samples[newest];
+    if (value != last.value) push(value, (lastPoll + now) / 2);
+    else if (now - last.time >= dataRate) push(value, now);
+    lastPoll = now;
+}
+
+double SampleStream::latest() const { return samples[newest].time; }
+
+float SampleStream::at(double time) const {
+    if (count == 0) return 0;
+    const Sample& last = samples[newest];
+    if (count == 1) return last.value;
+
+    // extrapolate past the newest sample, by at most one data period
+    if (time >= last.time) {
+        time = std::min<double>(time, last.time + dataRate);
+        const Sample& previous = samples[(newest + samples.size() - 1) % samples.size()];
+        if (last.time == previous.time) return last.value;
+        return last.value + (last.value - previous.value) * (time - last.time) / (last.time - previous.time);
+    }
+
+    // walk back to the samples around the instant
+    for (std::uint8_t i = 1; i < count; i++) {
+        const Sample& after = samples[(newest + samples.size() - i + 1) % samples.size()];
+        const Sample& before = samples[(newest + samples.size() - i) % samples.size()];
+        if (time >= before.time) {
+            return before.value + (after.value - before.value) * (time - before.time) / (after.time - before.time);
+        }
+    }
+    return samples[(newest + samples.size() - count + 1) % samples.size()].value;
+}
+} // namespace robot
@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "robot/telemetry.hpp"
+
+namespace robot {
+namespace {
+/** sync, type and length before the payload */
+constexpr std::size_t FRAME_HEADER = 5;
+/** CRC after the payload */
+constexpr std::size_t FRAME_FOOTER = 2;
+/** longest a varint of a 32-bit number gets */
+constexpr std::size_t MAX_VARINT = 5;
+/** longest payload a frame can have, a schema with the most channels and the longest names */
+constexpr std::size_t MAX_PAYLOAD = 1 + TELEMETRY_MAX_CHANNELS * (1 + sizeof(float) + 1 + 255);
+
+std::uint8_t* putVarint(std::uint8_t* out, std::uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = std::uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *out++ = std::uint8_t(value);
+    return out;
+}
+
+std::uint8_t* putFloat(std::uint8_t* out, float value) {
+    std::memcpy(out, &value, sizeof(float));
+    return out + sizeof(float);
+}
+
+/**
+ * @brief Map signed numbers to unsigned ones so small negative numbers stay small: 0, -1, 1, -2, 2 -> 0, 1, 2, 3, 4
+ */
+std::uint32_t zigzag(std::int32_t value) { return (std::uint32_t(value) << 1) ^ std::uint32_t(value >> 31); }
+
+std::int32_t unzigzag(std::uint32_t value) { return std::int32_t(value >> 1) ^ -std::int32_t(value & 1); }
+
+/**
+ * @brief Reads the fields of a payload, remembering if it ran past the end
+ */
+struct Reader {
+        const std::uint8_t* data;
+        const std::uint8_t* end;
+        bool failed = false;
+
+        std::uint8_t byte() {
+            if (data == end) {
+                failed = true;
+                return 0;
+            }
+            return *data++;
+        }
+
+        std::uint32_t varint() {
+            std::uint32_t value = 0;
+            for (int shift = 0; shift < 35; shift += 7) {
+                const std::uint8_t next = byte();
+                value |= std::uint32_t(next & 0x7F) << shift;
+                if (!(next & 0x80)) return value;
+            }
+            failed = true;
+            return 0;
+        }
+
+        float real() {
+            if (end - data < std::ptrdiff_t(sizeof(float))) {
+                failed = true;
+                data = end;
+                return 0;
+            }
+            float value;
+            std::memcpy(&value, data, sizeof(float));
+            data += sizeof(float);
+            return value;
+        }
+};
+
+/**
+ * @brief Fill in the sync, type, length and CRC around a payload written after the frame header
+ *
+ * @return the size of the whole frame
+ */
+std::size_t seal(std::uint8_t* frame, TelemetryFrame type, std::size_t payload) {
+    frame[0] = TELEMETRY_SYNC[0];
+    frame[1] = TELEMETRY_SYNC[1];
+    frame[2] = std::uint8_t(type);
+    frame[3] = std::uint8_t(payload);
+    frame[4] = std::uint8_t(payload >> 8);
+    const std::uint16_t crc = crc16(frame + 2, FRAME_HEADER - 2 + payload);
+    frame[FRAME_HEADER + payload] = std::uint8_t(crc);
+    frame[FRAME_HEADER + payload + 1] = std::uint8_t(crc >> 8);
+    return FRAME_HEADER + payload + FRAME_FOOTER;
+}
+} // namespace
+
+std::uint16_t crc16(const std::uint8_t* data, std::size_t size, std::uint16_t crc) {
+    for (std::size_t i = 0; i < size; i++) {
+        crc ^= std::uint16_t(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++) crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+std::size_t encodeTelemetryText(std::uint32_t time, std::uint8_t level, const char* text, std::size_t length,
+                                std::uint8_t* out) {
+    length = std::min(length, TELEMETRY_MAX_TEXT);
+    std::uint8_t* field = putVarint(out + FRAME_HEADER, time);
+    *field++ = level;
+    std::memcpy(field, text, length);
+    field += length;
+    return seal(out, TelemetryFrame::TEXT, field - out - FRAME_HEADER);
+}
+
+std::size_t encodeTelemetryFooter(std::uint32_t samples, std::uint32_t dropped, std::uint8_t* out) {
+    std::uint8_t* field = putVarint(out + FRAME_HEADER, samples);
+    field = putVarint(field, dropped);
+    return seal(out, TelemetryFrame::FOOTER, field - out - FRAME_HEADER);
+}
+
+TelemetryEncoder::TelemetryEncoder(std::vector<TelemetryChannel> channels, std::uint32_t keyInterval)
+    : channels(channels),
+      keyInterval(std::max<std::uint32_t>(keyInterval, 1)),
+      last(std::min(channels.size(), TELEMETRY_MAX_CHANNELS), 0) {
+    this->channels.resize(last.size());
+    for (TelemetryChannel& channel : this->channels) {
+        if (channel.name.size() > 255) channel.name.resize(255);
+    }
+}
+
+std::vector<std::uint8_t> TelemetryEncoder::schema() const {
+    std::vector<std::uint8_t> frame(FRAME_HEADER + 1);
+    frame.back() = std::uint8_t(channels.size());
+    for (const TelemetryChannel& channel : channels) {
+        const std::size_t start = frame.size();
+        frame.resize(start + 1 + sizeof(float) + 1 + channel.name.size());
+        frame[start] = std::uint8_t(channel.type);
+        std::uint8_t* name = putFloat(&frame[start + 1], channel.scale);
+        *name++ = std::uint8_t(channel.name.size());
+        std::memcpy(name, channel.name.data(), channel.name.size());
+    }
+    const std::size_t payload = frame.size() - FRAME_HEADER;
+    frame.resize(frame.size() + FRAME_FOOTER);
+    seal(frame.data(), TelemetryFrame::SCHEMA, payload);
+    return frame;
+}
+
+std::size_t TelemetryEncoder::encode(std::uint32_t time, const float* values, std::uint8_t* out) {
+    const bool key = untilKey == 0;
+    untilKey = key ? keyInterval - 1 : untilKey - 1;
+
+    std::uint8_t* field = out + FRAME_HEADER;
+    *field++ = sequence++;
+    field = putVarint(field, key ? time : time - lastTime);
+    lastTime = time;
+    for (std::size_t i = 0; i < channels.size(); i++) {
+        if (channels[i].type == TelemetryType::FLOAT) {
+            field = putFloat(field, values[i]);
+            continue;
+        }
+        // NaN goes out as 0, out of range values as the closest integer
+        const float scaled = std::isnan(values[i]) ? 0 : values[i] * channels[i].scale;
+        const std::int32_t value = std::int32_t(std::clamp(std::round(scaled), -2147483520.0f, 2147483520.0f));
+        field = putVarint(field, zigzag(key ? value : std::int32_t(std::uint32_t(value) - std::uint32_t(last[i]))));
+        last[i] = value;
+    }
+    return seal(out, key ? TelemetryFrame::KEY : TelemetryFrame::DELTA, field - out - FRAME_HEADER);
+}
+
+void TelemetryEncoder::forceKey() { untilKey = 0; }
+
+std::size_t TelemetryEncoder::getMaxSampleSize() const {
+    return FRAME_HEADER + 1 + MAX_VARINT + channels.size() * MAX_VARINT + FRAME_FOOTER;
+}
+
+const std::vector<TelemetryChannel>& TelemetryEncoder::getChannels() const { return channels; }
+
+void TelemetryDecoder::push(const std::uint8_t* data, std::size_t size) {
+    buffer.insert(buffer.end(), data, data + size);
+}
+
+TelemetryEvent TelemetryDecoder::next() {
+    std::size_t start = 0;
+    TelemetryEvent event = TelemetryEvent::NONE;
+    while (event == TelemetryEvent::NONE) {
+        // find the next sync
+        while (start + 1 < buffer.size() &&
+               (buffer[start] != TELEMETRY_SYNC[0] || buffer[start + 1] != TELEMETRY_SYNC[1]))
+            start++;
+        if (start + FRAME_HEADER > buffer.size()) break;
+        const std::size_t payload = buffer[start + 3] | std::size_t(buffer[start + 4]) << 8;
+        if (payload > MAX_PAYLOAD) {
+            corrupt++;
+            start++;
+            continue;
+        }
+        if (start + FRAME_HEADER + payload + FRAME_FOOTER > buffer.size()) break;
+
+        const std::uint8_t* frame = &buffer[start];
+        const std::uint16_t crc = frame[FRAME_HEADER + payload] | frame[FRAME_HEADER + payload + 1] << 8;
+        if (crc16(frame + 2, FRAME_HEADER - 2 + payload) != crc) {
+            // not a frame after all, or a damaged one. Look for the next sync inside it
+            corrupt++;
+            start++;
+            continue;
+        }
+        event = decode(TelemetryFrame(frame[2]), frame + FRAME_HEADER, payload);
+        start += FRAME_HEADER + payload + FRAME_FOOTER;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + std::min(start, buffer.size()));
+    return event;
+}
+
+TelemetryEvent TelemetryDecoder::decode(TelemetryFrame type, const std::uint8_t* payload, std::size_t size) {
+    Reader reader {payload, payload + size};
+    if (type == TelemetryFrame::SCHEMA) {
+        std::vector<TelemetryChannel> schema(reader.byte());
+        for (TelemetryChannel& channel : schema) {
+            channel.type = TelemetryType(reader.byte());
+            channel.scale = reader.real();
+            const std::size_t length = reader.byte();
+            if (reader.failed || std::size_t(reader.end - reader.data) < length) {
+                corrupt++;
+                return TelemetryEvent::NONE;
+            }
+            channel.name.assign(reinterpret_cast<const char*>(reader.data), length);
+            reader.data += length;
+        }
+        if (reader.failed) {
+            corrupt++;
+            return TelemetryEvent::NONE;
+        }
+        // the schema is sent over and over so a decoder can join late, only a different one is news
+        const bool same = schema.size() == channels.size() &&
+                          std::equal(schema.begin(), schema.end(), channels.begin(), [](const auto& a, const auto& b) {
+                              return a.name == b.name && a.type == b.type && a.scale == b.scale;
+                          });
+        if (same) return TelemetryEvent::NONE;
+        channels = schema;
+        last.assign(channels.size(), 0);
+        values.assign(channels.size(), 0);
+        synced = false;
+        return TelemetryEvent::SCHEMA;
+    }
+    if (type == TelemetryFrame::TEXT) {
+        const std::uint32_t textTime = reader.varint();
+        const std::uint8_t level = reader.byte();
+        if (reader.failed) {
+            corrupt++;
+            return TelemetryEvent::NONE;
+        }
+        text = {textTime, level, std::string(reinterpret_cast<const char*>(reader.data), reader.end - reader.data)};
+        return TelemetryEvent::TEXT;
+    }
+    if (type == TelemetryFrame::FOOTER) {
+        const std::uint32_t samples = reader.varint();
+        const std::uint32_t dropped = reader.varint();
+        if (reader.failed || reader.data != reader.end) {
+            corrupt++;
+            return TelemetryEvent::NONE;
+        }
+        footer = {samples, dropped};
+        return TelemetryEvent::FOOTER;
+    }
+    if (type != TelemetryFrame::KEY && type != TelemetryFrame::DELTA) {
+        corrupt++;
+        return TelemetryEvent::NONE;
+    }
+
+    const bool key = type == TelemetryFrame::KEY;
+    const std::uint8_t number = reader.byte();
+    if (channels.empty() || (!key && (!synced || number != std::uint8_t(sequence + 1)))) {
+        skipped++;
+        synced = false;
+        return TelemetryEvent::NONE;
+    }
+    const std::uint32_t frameTime = reader.varint();
+    std::vector<std::int32_t> integers = last;
+    std::vector<float> decoded(channels.size());
+    for (std::size_t i = 0; i < channels.size(); i++) {
+        if (channels[i].type == TelemetryType::FLOAT) {
+            decoded[i] = reader.real();
+            continue;
+        }
+        const std::int32_t value = unzigzag(reader.varint());
+        integers[i] = key ? value : std::int32_t(std::uint32_t(integers[i]) + std::uint32_t(value));
+        decoded[i] = channels[i].scale != 0 ? integers[i] / channels[i].scale : 0;
+    }
+    if (reader.failed || reader.data != reader.end) {
+        corrupt++;
+        synced = false;
+        return TelemetryEvent::NONE;
+    }
+    sequence = number;
+    time = key ? frameTime : time + frameTime;
+    last = integers;
+    values = decoded;
+    synced = true;
+    return TelemetryEvent::SAMPLE;
+}
+
+const std::vector<TelemetryChannel>& TelemetryDecoder::getChannels() const { return channels; }
+
+std::uint32_t TelemetryDecoder::getTime() const { return time; }
+
+const std::vector<float>& TelemetryDecoder::getValues() const { return values; }
+
+const TelemetryText& TelemetryDecoder::getText() const { return text; }
+
+const TelemetryFooter& TelemetryDecoder::getFooter() const { return footer; }
+
+std::uint32_t TelemetryDecoder::getCorrupt() const { return corrupt; }
+
+std::uint32_t TelemetryDecoder::getSkipped() const { return skipped; }
+} // namespace robot
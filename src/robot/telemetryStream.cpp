@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "pros/apix.h"
+#include "robot/telemetryStream.hpp"
+
+namespace robot {
+namespace {
+/** time between schema frames, in milliseconds */
+constexpr std::uint32_t SCHEMA_INTERVAL = 1000;
+/** time between writes to stdout, in milliseconds */
+constexpr std::uint32_t WRITE_RATE = 10;
+} // namespace
+
+TelemetryStream::TelemetryStream(std::vector<TelemetryChannel> channels, std::size_t capacity)
+    : encoder(channels),
+      schema(encoder.schema()),
+      frame(encoder.getMaxSampleSize()),
+      ring(capacity) {}
+
+void TelemetryStream::start() {
+    if (task) return;
+    pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+    task.emplace([this] {
+        while (true) {
+            flush();
+            pros::delay(WRITE_RATE);
+        }
+    });
+}
+
+void TelemetryStream::record(std::initializer_list<float> values) {
+    float samples[TELEMETRY_MAX_CHANNELS] = {};
+    std::copy_n(values.begin(), std::min(values.size(), encoder.getChannels().size()), samples);
+    const std::size_t size = encoder.encode(pros::millis(), samples, frame.data());
+    std::uint8_t* data = ring.reserve(size);
+    // the next frame can't be a difference from one the computer never gets
+    if (data == nullptr) {
+        encoder.forceKey();
+        return;
+    }
+    std::memcpy(data, frame.data(), size);
+    ring.commit(data, size);
+}
+
+std::uint32_t TelemetryStream::getDropped() const { return ring.getDropped(); }
+
+void TelemetryStream::flush() {
+    const std::uint32_t now = pros::millis();
+    if (lastSchema == 0 || now - lastSchema >= SCHEMA_INTERVAL) {
+        std::fwrite(schema.data(), 1, schema.size(), stdout);
+        lastSchema = std::max<std::uint32_t>(now, 1);
+    }
+    for (RingRecord record = ring.front(); record.data != nullptr; record = ring.front()) {
+        std::fwrite(record.data, 1, record.size, stdout);
+        ring.pop();
+    }
+    std::fflush(stdout);
+}
+} // namespace robot
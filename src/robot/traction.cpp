@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <cmath>
+#include "robot/traction.hpp"
+
+namespace robot {
+namespace {
+/** weight of each new slip reading, the encoders are noisy from one update to the next */
+constexpr float SLIP_FILTER = 0.5;
+/** slip has to drop to this fraction of the threshold before the side grips again */
+constexpr float HYSTERESIS = 0.5;
+} // namespace
+
+TractionControl::TractionControl(TractionSettings settings)
+    : settings(settings) {}
+
+float TractionControl::update(float power, float wheelVelocity, float groundVelocity, float gripPower, float time) {
+    const float speed = std::max({std::fabs(wheelVelocity), std::fabs(groundVelocity), settings.minVelocity});
+    slip += SLIP_FILTER * ((wheelVelocity - groundVelocity) / speed - slip);
+    if (std::fabs(slip) > settings.threshold) slipping = true;
+    else if (std::fabs(slip) < settings.threshold * HYSTERESIS) slipping = false;
+
+    // stopping is never delayed
+    if (slipping) limited = true;
+    if (power == 0 || !limited) {
+        output = power;
+        limited = false;
+        return output;
+    }
+    // wheels spinning in the direction they're driven lose grip from too much power, back off until they grip. The
+    // ground speed takes no power when the side is pushing something, so keep at least enough to push
+    float target = power;
+    if (slipping && slip * power > 0) {
+        const float grip = std::max(std::fabs(gripPower), settings.minPower);
+        target = std::copysign(std::min(grip, std::fabs(power)), power);
+    }
+    if (target * output >= 0 && std::fabs(target) <= std::fabs(output)) {
+        // easing off never costs grip
+        output = target;
+    } else {
+        const float change = settings.slew * time;
+        output += std::clamp(target - output, -change, change);
+    }
+    // the wheels gripped again and the power caught up
+    if (!slipping && output == power) limited = false;
+    return output;
+}
+
+void TractionControl::reset() {
+    slip = 0;
+    slipping = false;
+    limited = false;
+    output = 0;
+}
+
+bool TractionControl::isSlipping() const { return slipping; }
+
+float TractionControl::getSlip() const { return slip; }
+} // namespace robot